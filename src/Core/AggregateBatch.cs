@@ -0,0 +1,65 @@
+using System.Numerics;
+
+namespace ToyConEngine
+{
+    // Same idea as MathBatch for AggregateNodes of one type: each input row is gathered
+    // into a lane array and folded into the accumulator with one Vector<float> op.
+    // Nodes with fewer inputs than the widest one are padded with the identity.
+    public sealed class AggregateBatch
+    {
+        public AggregateNode.AggregateType Type { get; }
+        public AggregateNode[] Nodes { get; }
+
+        private readonly float[] _acc, _row;
+        private readonly int _rows;
+
+        public AggregateBatch(AggregateNode.AggregateType type, AggregateNode[] nodes)
+        {
+            Type = type;
+            Nodes = nodes;
+
+            int width = Vector<float>.Count;
+            int padded = (nodes.Length + width - 1) / width * width;
+            _acc = new float[padded];
+            _row = new float[padded];
+            foreach (var n in nodes) if (n.InputCount > _rows) _rows = n.InputCount;
+        }
+
+        public void Run()
+        {
+            int width = Vector<float>.Count;
+            float identity = AggregateNode.Identity(Type);
+
+            Gather(0, _acc, identity);
+            for (int row = 1; row < _rows; row++)
+            {
+                Gather(row, _row, identity);
+                for (int i = 0; i < _acc.Length; i += width)
+                {
+                    var acc = new Vector<float>(_acc, i);
+                    var v = new Vector<float>(_row, i);
+                    switch (Type)
+                    {
+                        case AggregateNode.AggregateType.Sum: acc += v; break;
+                        case AggregateNode.AggregateType.Product: acc *= v; break;
+                        case AggregateNode.AggregateType.Min: acc = MathBatch.Min(acc, v); break;
+                        default: acc = MathBatch.Max(acc, v); break;
+                    }
+                    acc.CopyTo(_acc, i);
+                }
+            }
+
+            for (int i = 0; i < Nodes.Length; i++)
+                Nodes[i].Outputs[0].SetValue(_acc[i]);
+        }
+
+        private void Gather(int row, float[] lanes, float identity)
+        {
+            for (int i = 0; i < Nodes.Length; i++)
+            {
+                var node = Nodes[i];
+                lanes[i] = row < node.InputCount ? node.Inputs[row].GetValue() : identity;
+            }
+        }
+    }
+}
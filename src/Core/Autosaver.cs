@@ -0,0 +1,74 @@
+using System;
+using System.IO;
+using System.IO.Compression;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // Periodic background autosave. The UI thread only copies the graph's raw state between
+    // ticks (GraphSnapshot.CaptureState); formatting node data, serialization, Brotli
+    // compression and disk I/O run on a worker. The newest save is
+    // autosave_1.toy, older ones shift up to autosave_<Versions>.toy.
+    public class Autosaver
+    {
+        public double IntervalSeconds { get; set; } = 60;
+        public int Versions { get; set; } = 5;
+        public string Directory { get; }
+        public string LastError { get; private set; }
+
+        private double _elapsed;
+        private Task _pending;
+        private string _lastWritten;
+
+        public Autosaver(string directory)
+        {
+            Directory = directory;
+        }
+
+        public void Update(double elapsedSeconds, Func<GraphSnapshot> capture)
+        {
+            _elapsed += elapsedSeconds;
+            if (_elapsed < IntervalSeconds) return;
+            if (_pending != null && !_pending.IsCompleted) return; // still writing the last one, try next frame
+
+            _elapsed = 0;
+            var snapshot = capture();
+            if (snapshot == null) return;
+            _pending = Task.Run(() => Write(snapshot));
+        }
+
+        public string PathFor(int version) => Path.Combine(Directory, $"autosave_{version}.toy");
+
+        private void Write(GraphSnapshot snapshot)
+        {
+            try
+            {
+                // Nothing changed since the last autosave: keep the rotation as it is
+                string text = snapshot.WithData((type, state) => DesignLoader.FormatNodeState(type, state)).ToString();
+                if (text == _lastWritten) return;
+
+                System.IO.Directory.CreateDirectory(Directory);
+                string temp = Path.Combine(Directory, "autosave.tmp");
+                using (var stream = new FileStream(temp, FileMode.Create, FileAccess.Write, FileShare.None))
+                {
+                    DesignFile.Write(stream, writer => writer.Write(text), DesignCompression.Brotli, CompressionLevel.Fastest);
+                    stream.Flush(true);
+                }
+
+                if (File.Exists(PathFor(Versions))) File.Delete(PathFor(Versions));
+                for (int v = Versions - 1; v >= 1; v--)
+                {
+                    if (File.Exists(PathFor(v))) File.Move(PathFor(v), PathFor(v + 1));
+                }
+                File.Move(temp, PathFor(1));
+
+                _lastWritten = text;
+                LastError = null;
+            }
+            catch (Exception e)
+            {
+                LastError = e.Message;
+            }
+        }
+    }
+}
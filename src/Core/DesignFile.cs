@@ -0,0 +1,97 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Text;
+
+namespace ToyConEngine
+{
+    public enum DesignCompression { None, Deflate, Brotli }
+
+    // Reading and writing .toy design files. Plain files are the TOYCON_v1 text;
+    // compressed files start with "TOYCONZ" plus one codec byte, followed by the same
+    // text run through a Deflate or Brotli stream. Readers sniff the header, so both
+    // kinds load through the same path.
+    public static class DesignFile
+    {
+        public static readonly byte[] CompressedMagic = Encoding.ASCII.GetBytes("TOYCONZ");
+        private const int BufferSize = 1 << 16;
+
+        // Written to a temp file next to the target and renamed over it, so a crash
+        // mid-write leaves the previous version intact instead of a truncated design.
+        public static void Save(string path, GraphSnapshot snapshot, DesignCompression compression = DesignCompression.None, CompressionLevel level = CompressionLevel.Optimal)
+        {
+            string temp = path + ".tmp";
+            using (var stream = new FileStream(temp, FileMode.Create, FileAccess.Write, FileShare.None, BufferSize))
+            {
+                Write(stream, snapshot.WriteTo, compression, level);
+                stream.Flush(true);
+            }
+            File.Move(temp, path, true);
+        }
+
+        public static void Write(Stream stream, Action<TextWriter> write, DesignCompression compression, CompressionLevel level = CompressionLevel.Optimal)
+        {
+            Stream body = stream;
+            if (compression != DesignCompression.None)
+            {
+                stream.Write(CompressedMagic, 0, CompressedMagic.Length);
+                stream.WriteByte(compression == DesignCompression.Brotli ? (byte)'B' : (byte)'D');
+                body = compression == DesignCompression.Brotli
+                    ? new BrotliStream(stream, level, true)
+                    : new DeflateStream(stream, level, true);
+            }
+
+            using (var writer = new StreamWriter(body, new UTF8Encoding(false), BufferSize, true))
+            {
+                write(writer);
+            }
+            if (body != stream) body.Dispose();
+        }
+
+        public static IEnumerable<string> ReadLines(string path)
+        {
+            // Opened lazily so the file is only held while the lines are being consumed
+            foreach (var line in ReadLines(new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, BufferSize, FileOptions.SequentialScan)))
+                yield return line;
+        }
+
+        // Lines are decoded as they are consumed; nothing holds the whole file in memory.
+        // Takes ownership of the stream.
+        public static IEnumerable<string> ReadLines(Stream stream)
+        {
+            using (var reader = OpenReader(stream))
+            {
+                string line;
+                while ((line = reader.ReadLine()) != null) yield return line;
+            }
+        }
+
+        // The stream must be seekable so a plain file can be rewound after sniffing the header
+        public static TextReader OpenReader(Stream stream)
+        {
+            long start = stream.Position;
+
+            var header = new byte[CompressedMagic.Length + 1];
+            int read = 0;
+            while (read < header.Length)
+            {
+                int n = stream.Read(header, read, header.Length - read);
+                if (n == 0) break;
+                read += n;
+            }
+
+            bool compressed = read == header.Length && header.AsSpan(0, CompressedMagic.Length).SequenceEqual(CompressedMagic);
+            if (!compressed)
+            {
+                stream.Seek(start, SeekOrigin.Begin);
+                return new StreamReader(stream, Encoding.UTF8, true, BufferSize);
+            }
+
+            Stream body = header[CompressedMagic.Length] == (byte)'B'
+                ? new BrotliStream(stream, CompressionMode.Decompress)
+                : new DeflateStream(stream, CompressionMode.Decompress);
+            return new StreamReader(body, Encoding.UTF8, true, BufferSize);
+        }
+    }
+}
@@ -0,0 +1,245 @@
+using Microsoft.Xna.Framework;
+using Microsoft.Xna.Framework.Input;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace ToyConEngine
+{
+    // Building graphs from design files and back, without any editor or window state,
+    // so the editor, patches and the headless host all load designs the same way.
+    public static class DesignLoader
+    {
+        public const int MaxToyDepth = 32;
+
+        // Set for the duration of the outermost load, so every toy inside it, however deeply
+        // nested, reads its file through one resolver
+        [ThreadStatic] private static ToyDependencyResolver _toys;
+        [ThreadStatic] private static int _toyDepth;
+
+        // Lines are consumed as they stream in (see DesignFile.ReadLines)
+        public static void Load(GraphEngine engine, IEnumerable<string> lines, Dictionary<Node, Rectangle> rects = null, PresentationLayout layout = null)
+        {
+            bool owner = _toys == null;
+            if (owner) _toys = new ToyDependencyResolver();
+            try { LoadLines(engine, lines, rects, layout); }
+            finally { if (owner) _toys = null; }
+        }
+
+        private static void LoadLines(GraphEngine engine, IEnumerable<string> lines, Dictionary<Node, Rectangle> rects, PresentationLayout layout)
+        {
+            engine.Clear();
+            rects?.Clear();
+            layout?.Clear();
+
+            var idToNode = new Dictionary<int, Node>();
+            bool first = true;
+
+            foreach (var line in lines)
+            {
+                if (first)
+                {
+                    first = false;
+                    if (line != GraphSnapshot.Header) break;
+                    continue;
+                }
+
+                var parts = line.Split(' ');
+                if (parts[0] == "NODE")
+                {
+                    int id = int.Parse(parts[1]);
+                    string type = parts[2];
+                    int x = int.Parse(parts[3]);
+                    int y = int.Parse(parts[4]);
+                    string data = parts.Length > 5 ? string.Join(" ", parts.Skip(5)) : "";
+
+                    Node n = CreateNodeOfType(type);
+                    if (n != null)
+                    {
+                        ApplyNodeData(n, data);
+                        // File IDs are kept so later patches can address the same nodes
+                        n.Id = id;
+                        engine.AddNode(n);
+                        if (rects != null) rects[n] = DefaultNodeRect(n, x, y);
+                        idToNode[id] = n;
+                    }
+                }
+                else if (parts[0] == "CONN")
+                {
+                    int srcId = int.Parse(parts[1]);
+                    int srcSlot = int.Parse(parts[2]);
+                    int tgtId = int.Parse(parts[3]);
+                    int tgtSlot = int.Parse(parts[4]);
+
+                    if (idToNode.TryGetValue(srcId, out var src) && idToNode.TryGetValue(tgtId, out var tgt))
+                    {
+                        // Wires to ports a node keeps but does not use are restored, not dropped
+                        if (src is IGrowablePorts growSource) growSource.EnsurePorts(0, srcSlot + 1);
+                        if (tgt is IGrowablePorts growTarget) growTarget.EnsurePorts(tgtSlot + 1, 0);
+                        if (srcSlot >= 0 && srcSlot < src.Outputs.Count && tgtSlot >= 0 && tgtSlot < tgt.Inputs.Count)
+                            engine.Connect(src, srcSlot, tgt, tgtSlot);
+                    }
+                }
+                else if (parts[0] == "VIEW" && layout != null)
+                {
+                    if (idToNode.TryGetValue(int.Parse(parts[1]), out var node))
+                        layout.Place(node, new Rectangle(int.Parse(parts[2]), int.Parse(parts[3]), int.Parse(parts[4]), int.Parse(parts[5])));
+                }
+            }
+            engine.Invalidate();
+        }
+
+        // A toy whose file is missing, refers back to itself or nests too deeply is left empty
+        // with the reason in LoadError
+        public static void LoadToyNode(ToyNode node)
+        {
+            node.LoadError = null;
+            if (string.IsNullOrEmpty(node.FilePath)) return;
+
+            bool owner = _toys == null;
+            if (owner) _toys = new ToyDependencyResolver();
+            try
+            {
+                _toys.Resolve(node.FilePath);
+                var lines = _toys.GetLines(node.FilePath, out var error);
+                if (lines != null && _toyDepth >= MaxToyDepth) error = $"toys nested more than {MaxToyDepth} deep";
+
+                if (error != null)
+                {
+                    node.LoadError = error;
+                    node.InternalEngine.Clear();
+                    node.InternalRects.Clear();
+                }
+                else
+                {
+                    _toyDepth++;
+                    try { LoadLines(node.InternalEngine, lines, node.InternalRects, null); }
+                    finally { _toyDepth--; }
+                }
+            }
+            finally { if (owner) _toys = null; }
+
+            node.UpdateLayoutHash();
+            node.RefreshPorts();
+        }
+
+        public static Node CreateNodeOfType(string type)
+        {
+            if (type == "ConstantNode") return new ConstantNode(0);
+            else if (type == "MathNode") return new MathNode(MathNode.Operation.Add);
+            else if (type == "LogicNode") return new LogicNode(LogicNode.LogicType.And);
+            else if (type == "AggregateNode") return new AggregateNode(AggregateNode.AggregateType.Sum);
+            else if (type == "TimerNode") return new TimerNode();
+            else if (type == "CounterNode") return new CounterNode();
+            else if (type == "MemoryNode") return new MemoryNode();
+            else if (type == "RandomNode") return new RandomNode();
+            else if (type == "ButtonNode") return new ButtonNode();
+            else if (type == "KeyNode") return new KeyNode();
+            else if (type == "CursorNode") return new CursorNode();
+            else if (type == "ColorOutputNode") return new ColorOutputNode();
+            else if (type == "BeepOutputNode") return new BeepOutputNode();
+            else if (type == "ScreenNode") return new ScreenNode();
+            else if (type == "ScriptImporterNode") return new ScriptImporterNode();
+            else if (type == "ToyNode") return new ToyNode();
+            else if (type == "ToyInputNode") return new ToyInputNode();
+            else if (type == "ToyOutputNode") return new ToyOutputNode();
+            else if (type == "SharedOutputNode") return new SharedOutputNode();
+            else if (type == "DataFileNode") return new DataFileNode();
+            return null;
+        }
+
+        public static Rectangle DefaultNodeRect(Node node, int x, int y)
+        {
+            int width = 100;
+            int height = 60;
+            if (node.Inputs.Count + node.Outputs.Count > 2)
+            {
+                width = 120;
+                height = 80;
+            }
+            if (node is ScreenNode)
+            {
+                width = 140;
+                height = 140;
+            }
+            if (node is ToyNode) { width = 160; height = 240; }
+            return new Rectangle(x, y, width, height);
+        }
+
+        public static string GetNodeData(Node node) => FormatNodeState(node.GetType().Name, CaptureNodeState(node));
+
+        // The settings GetNodeData writes, copied without formatting
+        public static NodeState CaptureNodeState(Node node)
+        {
+            if (node is ConstantNode c) return new NodeState(value: c.StoredValue);
+            if (node is MathNode m) return new NodeState(kind: (int)m.Op);
+            if (node is LogicNode l) return new NodeState(kind: (int)l.Type);
+            if (node is AggregateNode a) return new NodeState(kind: (int)a.Type, count: a.InputCount);
+            if (node is KeyNode k) return new NodeState(kind: (int)k.Key);
+            if (node is ButtonNode b) return new NodeState(flag: b.IsToggle);
+            if (node is BeepOutputNode beep) return new NodeState(text: beep.SoundName);
+            if (node is CounterNode cnt) return new NodeState(value: cnt.Value);
+            if (node is MemoryNode mem) return new NodeState(flag: mem.IsReadOnly, floats: (float[])mem.Data.Clone());
+            if (node is ScriptImporterNode s) return new NodeState(text: s.Script);
+            if (node is ToyNode t) return new NodeState(text: t.FilePath ?? "");
+            if (node is ToyInputNode tin) return new NodeState(count: tin.Index);
+            if (node is ToyOutputNode ton) return new NodeState(count: ton.Index);
+            if (node is SharedOutputNode so) return new NodeState(count: so.Bank);
+            if (node is DataFileNode df) return new NodeState(text: df.FilePath);
+            return default;
+        }
+
+        // The design file data of a node of this type (its class name) with these settings
+        public static string FormatNodeState(string type, in NodeState state)
+        {
+            switch (type)
+            {
+                case "ConstantNode":
+                case "CounterNode": return state.Value.ToString();
+                case "MathNode": return ((MathNode.Operation)state.Kind).ToString();
+                case "LogicNode": return ((LogicNode.LogicType)state.Kind).ToString();
+                case "AggregateNode": return $"{(AggregateNode.AggregateType)state.Kind} {state.Count}";
+                case "KeyNode": return ((Keys)state.Kind).ToString();
+                case "ButtonNode": return state.Flag.ToString();
+                case "BeepOutputNode": return state.Text;
+                case "MemoryNode": return MemoryNode.Serialize(state.Floats, state.Flag);
+                case "ScriptImporterNode":
+                case "ToyNode":
+                case "DataFileNode": return Convert.ToBase64String(Encoding.UTF8.GetBytes(state.Text));
+                case "ToyInputNode":
+                case "ToyOutputNode":
+                case "SharedOutputNode": return state.Count.ToString();
+                default: return "";
+            }
+        }
+
+        public static void ApplyNodeData(Node node, string data)
+        {
+            if (string.IsNullOrEmpty(data)) return;
+            try {
+                if (node is ConstantNode c) c.StoredValue = float.Parse(data);
+                if (node is MathNode m) { m.Op = Enum.Parse<MathNode.Operation>(data); m.Name = $"Math ({m.Op})"; }
+                if (node is LogicNode l) { l.Type = Enum.Parse<LogicNode.LogicType>(data); l.Name = $"Logic ({l.Type})"; }
+                if (node is AggregateNode a)
+                {
+                    var fields = data.Split(' ');
+                    a.Type = Enum.Parse<AggregateNode.AggregateType>(fields[0]);
+                    a.InputCount = fields.Length > 1 ? int.Parse(fields[1]) : AggregateNode.MinInputs;
+                }
+                if (node is KeyNode k) { k.Key = Enum.Parse<Keys>(data); k.Name = $"Key ({k.Key})"; }
+                if (node is ButtonNode b) b.IsToggle = bool.Parse(data);
+                if (node is BeepOutputNode beep) beep.SoundName = data;
+                if (node is CounterNode cnt) cnt.Value = float.Parse(data);
+                if (node is MemoryNode mem) mem.Deserialize(data);
+                if (node is ScriptImporterNode s) s.Script = Encoding.UTF8.GetString(Convert.FromBase64String(data));
+                if (node is ToyNode t) { t.FilePath = Encoding.UTF8.GetString(Convert.FromBase64String(data)); LoadToyNode(t); }
+                if (node is ToyInputNode tin) tin.Index = int.Parse(data);
+                if (node is ToyOutputNode ton) ton.Index = int.Parse(data);
+                if (node is SharedOutputNode so) so.Bank = int.Parse(data);
+                if (node is DataFileNode df) df.FilePath = Encoding.UTF8.GetString(Convert.FromBase64String(data));
+            } catch {}
+        }
+    }
+}
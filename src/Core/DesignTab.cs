@@ -0,0 +1,35 @@
+using Microsoft.Xna.Framework;
+using System.Collections.Generic;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // One open design in the workspace: its own engine and node positions, plus how
+    // the scheduler should run it while it is not the tab being edited.
+    public class DesignTab
+    {
+        public string Name { get; set; }
+        public string FilePath { get; set; }
+        public GraphEngine Engine { get; } = new GraphEngine();
+        public Dictionary<Node, Rectangle> Rects { get; } = new Dictionary<Node, Rectangle>();
+        public PresentationLayout Layout { get; } = new PresentationLayout();
+
+        // Background ticks per second; the active tab follows the editor loop instead
+        public double TickRate { get; set; } = 60;
+        // Higher runs first when there are more due designs than workers
+        public int Priority { get; set; }
+
+        // Editor state kept while the tab is in the background
+        public GraphSnapshot Baseline { get; set; }
+        public bool AutoLayout { get; set; }
+
+        internal double Due;
+        internal Task Running;
+        internal long TotalTicks;
+
+        public DesignTab(string name)
+        {
+            Name = name;
+        }
+    }
+}
@@ -0,0 +1,236 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace ToyConEngine
+{
+    // The compiled form of a graph: nodes sorted into topological levels so a signal
+    // reaches every downstream node in the same tick. Inside a level no node depends
+    // on another, so same-op MathNodes (and same-type AggregateNodes) can be evaluated
+    // together as one batch.
+    public sealed class ExecutionPlan
+    {
+        // Smaller groups are cheaper to evaluate one node at a time
+        public const int MinBatchSize = 4;
+
+        public sealed class Level
+        {
+            public Node[] Nodes;
+            public MathBatch[] Batches;
+            public AggregateBatch[] Aggregates;
+        }
+
+        public Level[] Levels { get; private set; }
+        public Dictionary<Node, int> NodeLevels { get; } = new Dictionary<Node, int>();
+        // Nodes left out because nothing visible depends on them (see GraphAnalyzer)
+        public int PrunedCount { get; private set; }
+        // Constants and the pure nodes fed only by them, evaluated at compile time instead of every tick
+        public int FoldedCount => _folded.Count;
+        // Partitioned plans only: index into Levels of every scheduled node, owned or not
+        public Dictionary<Node, int> LevelOf { get; } = new Dictionary<Node, int>();
+
+        private readonly List<Node> _folded = new List<Node>();
+        private readonly Dictionary<Node, int> _foldedIndex = new Dictionary<Node, int>();
+        private readonly Dictionary<Node, List<Node>> _foldedConsumers = new Dictionary<Node, List<Node>>();
+        private static readonly GameTime NoTime = new GameTime();
+
+        // With `owned`, levels keep their positions but only hold the owned nodes, so plans
+        // compiled for different partitions of the same graph line up level by level.
+        public static ExecutionPlan Compile(List<Node> nodes, bool pruneDead = false, Predicate<Node> owned = null)
+        {
+            var plan = new ExecutionPlan();
+            var levels = ComputeLevels(nodes, plan.NodeLevels);
+
+            // Levels are computed on the full graph so NodeLevels still covers every node
+            if (pruneDead)
+            {
+                var live = GraphAnalyzer.FindLive(nodes, keepState: true);
+                foreach (var level in levels) plan.PrunedCount += level.RemoveAll(n => !live.Contains(n));
+                levels.RemoveAll(l => l.Count == 0);
+            }
+
+            plan.Fold(levels);
+            levels.RemoveAll(l => l.Count == 0);
+
+            if (owned != null)
+            {
+                for (int i = 0; i < levels.Count; i++)
+                {
+                    foreach (var n in levels[i]) plan.LevelOf[n] = i;
+                    levels[i].RemoveAll(n => !owned(n));
+                }
+            }
+
+            plan.Levels = new Level[levels.Count];
+            for (int i = 0; i < levels.Count; i++)
+            {
+                // The last level holds feedback loops when there are any; order matters there
+                bool cyclic = levels[i].Any(n => plan.NodeLevels[n] < 0);
+                plan.Levels[i] = cyclic ? new Level { Nodes = levels[i].ToArray(), Batches = new MathBatch[0], Aggregates = new AggregateBatch[0] } : BuildLevel(levels[i]);
+            }
+            return plan;
+        }
+
+        // afterLevel is called with each level's index once it has run (partition exchange points)
+        public void Run(GameTime gameTime, Action<int> afterLevel = null)
+        {
+            for (int i = 0; i < Levels.Length; i++)
+            {
+                var level = Levels[i];
+                foreach (var batch in level.Batches) batch.Run();
+                foreach (var batch in level.Aggregates) batch.Run();
+                foreach (var node in level.Nodes) node.Evaluate(gameTime);
+                afterLevel?.Invoke(i);
+            }
+        }
+
+        // Walks the levels in order, so every source of a node is classified before the node.
+        // Folded nodes are evaluated once and removed from their level; their outputs then act
+        // as fixed slots for the rest of the graph.
+        private void Fold(List<List<Node>> levels)
+        {
+            foreach (var level in levels)
+            {
+                if (level.Count == 0 || NodeLevels[level[0]] < 0) continue; // feedback loops keep running
+
+                foreach (var node in level)
+                {
+                    if (!GraphAnalyzer.IsPure(node)) continue;
+
+                    bool constant = true;
+                    foreach (var input in node.Inputs)
+                    {
+                        foreach (var source in input.ConnectedSources)
+                        {
+                            if (!_foldedIndex.ContainsKey(source.ParentNode)) { constant = false; break; }
+                        }
+                        if (!constant) break;
+                    }
+                    if (!constant) continue;
+
+                    _foldedIndex[node] = _folded.Count;
+                    _folded.Add(node);
+                    foreach (var input in node.Inputs)
+                    {
+                        foreach (var source in input.ConnectedSources)
+                        {
+                            if (!_foldedConsumers.TryGetValue(source.ParentNode, out var list)) _foldedConsumers[source.ParentNode] = list = new List<Node>();
+                            list.Add(node);
+                        }
+                    }
+                }
+                level.RemoveAll(_foldedIndex.ContainsKey);
+            }
+
+            foreach (var node in _folded) node.Evaluate(NoTime);
+        }
+
+        // Recomputes only the folded nodes downstream of an edited constant, in dependency order
+        public void Respecialize(ConstantNode changed)
+        {
+            if (!_foldedIndex.ContainsKey(changed)) return;
+
+            var region = new List<Node>();
+            var visited = new HashSet<Node> { changed };
+            var stack = new Stack<Node>();
+            stack.Push(changed);
+            while (stack.Count > 0)
+            {
+                var node = stack.Pop();
+                region.Add(node);
+                if (!_foldedConsumers.TryGetValue(node, out var consumers)) continue;
+                foreach (var c in consumers) if (visited.Add(c)) stack.Push(c);
+            }
+
+            region.Sort((a, b) => _foldedIndex[a].CompareTo(_foldedIndex[b]));
+            foreach (var node in region) node.Evaluate(NoTime);
+        }
+
+        // Kahn's algorithm. Nodes caught in a feedback loop get level -1 and are run
+        // last, in list order, like the old linear engine did.
+        public static List<List<Node>> ComputeLevels(List<Node> nodes, Dictionary<Node, int> nodeLevels)
+        {
+            var index = new Dictionary<Node, int>(nodes.Count);
+            for (int i = 0; i < nodes.Count; i++) index[nodes[i]] = i;
+
+            var inDegree = new int[nodes.Count];
+            var consumers = new List<int>[nodes.Count];
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                foreach (var input in nodes[i].Inputs)
+                {
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        if (!index.TryGetValue(source.ParentNode, out int src)) continue;
+                        (consumers[src] ??= new List<int>()).Add(i);
+                        inDegree[i]++;
+                    }
+                }
+            }
+
+            var levels = new List<List<Node>>();
+            var current = new List<int>();
+            for (int i = 0; i < nodes.Count; i++) if (inDegree[i] == 0) current.Add(i);
+
+            int placed = 0;
+            while (current.Count > 0)
+            {
+                var next = new List<int>();
+                var row = new List<Node>(current.Count);
+                foreach (int i in current)
+                {
+                    row.Add(nodes[i]);
+                    nodeLevels[nodes[i]] = levels.Count;
+                    placed++;
+                    if (consumers[i] == null) continue;
+                    foreach (int c in consumers[i])
+                    {
+                        if (--inDegree[c] == 0) next.Add(c);
+                    }
+                }
+                levels.Add(row);
+                next.Sort();
+                current = next;
+            }
+
+            if (placed < nodes.Count)
+            {
+                var cyclic = new List<Node>();
+                foreach (var node in nodes)
+                {
+                    if (nodeLevels.ContainsKey(node)) continue;
+                    nodeLevels[node] = -1;
+                    cyclic.Add(node);
+                }
+                levels.Add(cyclic);
+            }
+            return levels;
+        }
+
+        private static Level BuildLevel(List<Node> nodes)
+        {
+            var scalar = new List<Node>();
+            var batches = new List<MathBatch>();
+
+            foreach (var group in nodes.OfType<MathNode>().GroupBy(m => m.Op))
+            {
+                var members = group.ToArray();
+                if (members.Length >= MinBatchSize) batches.Add(new MathBatch(group.Key, members));
+            }
+
+            var aggregates = new List<AggregateBatch>();
+            foreach (var group in nodes.OfType<AggregateNode>().GroupBy(a => a.Type))
+            {
+                var members = group.ToArray();
+                if (members.Length >= MinBatchSize) aggregates.Add(new AggregateBatch(group.Key, members));
+            }
+
+            var batched = new HashSet<Node>(batches.SelectMany(b => b.Nodes));
+            batched.UnionWith(aggregates.SelectMany(b => b.Nodes));
+            foreach (var node in nodes) if (!batched.Contains(node)) scalar.Add(node);
+
+            return new Level { Nodes = scalar.ToArray(), Batches = batches.ToArray(), Aggregates = aggregates.ToArray() };
+        }
+    }
+}
@@ -0,0 +1,189 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Concurrent;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+using System.Threading.Channels;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    public enum FrameFormat { Y4M, Raw, Png }
+
+    // Records every Nth ScreenNode frame. The tick only copies the framebuffer into a
+    // pooled buffer and offers it to a bounded queue; encoding and disk I/O happen on
+    // workers. When the queue is full the frame is dropped and counted, never waited for.
+    //   .y4m  - one uncompressed YUV 4:4:4 stream (plays in ffmpeg/mpv)
+    //   .rgba - raw RGBA8 frames back to back
+    //   other - a directory of frame_000000.png files, encoded by a worker pool
+    public sealed class FrameExporter : IDisposable
+    {
+        public const int QueueCapacity = 64;
+
+        public string Target { get; }
+        public FrameFormat Format { get; }
+        public int Every { get; }
+        public long Captured => Interlocked.Read(ref _captured);
+        public long Written => Interlocked.Read(ref _written);
+        public long Dropped => Interlocked.Read(ref _dropped);
+        public string LastError { get; private set; }
+
+        private readonly struct Frame
+        {
+            public readonly long Index;
+            public readonly Color[] Pixels;
+            public Frame(long index, Color[] pixels) { Index = index; Pixels = pixels; }
+        }
+
+        private readonly Channel<Frame> _queue;
+        private readonly ConcurrentBag<Color[]> _pool = new ConcurrentBag<Color[]>();
+        private readonly Task[] _workers;
+        private readonly Stream _stream;
+        private long _captured, _written, _dropped;
+
+        // The screen is looked up again only when the engine recompiles its plan
+        private ExecutionPlan _plan;
+        private ScreenNode _screen;
+
+        public static FrameFormat FormatFor(string target)
+        {
+            string ext = Path.GetExtension(target).ToLowerInvariant();
+            return ext == ".y4m" ? FrameFormat.Y4M : ext == ".rgba" || ext == ".raw" ? FrameFormat.Raw : FrameFormat.Png;
+        }
+
+        public FrameExporter(string target, int every = 1, double fps = 60, int encoders = 0)
+        {
+            Target = target;
+            Format = FormatFor(target);
+            Every = Math.Max(1, every);
+
+            _queue = Channel.CreateBounded<Frame>(new BoundedChannelOptions(QueueCapacity)
+            {
+                FullMode = BoundedChannelFullMode.Wait, // TryWrite fails instead of blocking
+                SingleWriter = true,
+                SingleReader = Format != FrameFormat.Png
+            });
+
+            if (Format == FrameFormat.Png)
+            {
+                Directory.CreateDirectory(target);
+                if (encoders <= 0) encoders = Math.Max(1, Environment.ProcessorCount / 2);
+                _workers = new Task[encoders];
+                for (int i = 0; i < encoders; i++) _workers[i] = Task.Run(WritePngs);
+            }
+            else
+            {
+                // Streams must stay in order, so a single writer
+                _stream = new FileStream(target, FileMode.Create, FileAccess.Write, FileShare.Read, 1 << 20);
+                if (Format == FrameFormat.Y4M)
+                {
+                    // Frame rate as a fraction with millihertz precision
+                    var header = Encoding.ASCII.GetBytes($"YUV4MPEG2 W{ScreenNode.Width} H{ScreenNode.Height} F{(long)Math.Round(fps / Every * 1000)}:1000 Ip A1:1 C444\n");
+                    _stream.Write(header, 0, header.Length);
+                }
+                _workers = new[] { Task.Run(WriteStream) };
+            }
+        }
+
+        // Hook for GraphEngine.Ticked
+        public void OnTick(GraphEngine engine)
+        {
+            if (engine.TickCount % Every != 0) return;
+
+            var plan = engine.Plan;
+            if (plan != _plan)
+            {
+                _plan = plan;
+                _screen = null;
+                foreach (var node in engine.Nodes) if (node is ScreenNode s) { _screen = s; break; }
+            }
+            if (_screen != null) Capture(_screen.Buffer);
+        }
+
+        public void Capture(Color[] pixels)
+        {
+            long index = Interlocked.Increment(ref _captured) - 1;
+            if (!_pool.TryTake(out var buffer) || buffer.Length != pixels.Length) buffer = new Color[pixels.Length];
+            Array.Copy(pixels, buffer, pixels.Length);
+
+            if (!_queue.Writer.TryWrite(new Frame(index, buffer)))
+            {
+                Interlocked.Increment(ref _dropped);
+                Return(buffer);
+            }
+        }
+
+        private void Return(Color[] buffer)
+        {
+            // Enough to refill the queue; anything beyond that is left to the GC
+            if (_pool.Count < QueueCapacity + _workers.Length) _pool.Add(buffer);
+        }
+
+        private async Task WriteStream()
+        {
+            var yuv = new byte[ScreenNode.Width * ScreenNode.Height * 3];
+            var frameHeader = Encoding.ASCII.GetBytes("FRAME\n");
+
+            await foreach (var frame in _queue.Reader.ReadAllAsync())
+            {
+                try
+                {
+                    if (Format == FrameFormat.Y4M)
+                    {
+                        ToYuv444(frame.Pixels, yuv);
+                        _stream.Write(frameHeader, 0, frameHeader.Length);
+                        _stream.Write(yuv, 0, yuv.Length);
+                    }
+                    else
+                    {
+                        _stream.Write(MemoryMarshal.AsBytes(frame.Pixels.AsSpan()));
+                    }
+                    Interlocked.Increment(ref _written);
+                }
+                // Anything a frame throws only loses that frame; an escaping exception would end
+                // the worker and leave the queue filling up with frames nobody writes
+                catch (Exception e) { LastError = e.Message; Interlocked.Increment(ref _dropped); }
+                finally { Return(frame.Pixels); }
+            }
+        }
+
+        private async Task WritePngs()
+        {
+            await foreach (var frame in _queue.Reader.ReadAllAsync())
+            {
+                try
+                {
+                    string path = Path.Combine(Target, $"frame_{frame.Index:D6}.png");
+                    using (var file = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.None, 1 << 16))
+                        PngWriter.Write(file, MemoryMarshal.AsBytes(frame.Pixels.AsSpan()), ScreenNode.Width, ScreenNode.Height);
+                    Interlocked.Increment(ref _written);
+                }
+                catch (Exception e) { LastError = e.Message; Interlocked.Increment(ref _dropped); }
+                finally { Return(frame.Pixels); }
+            }
+        }
+
+        // BT.601 studio range, which is what Y4M players assume
+        private static void ToYuv444(Color[] pixels, byte[] yuv)
+        {
+            int plane = pixels.Length;
+            for (int i = 0; i < plane; i++)
+            {
+                int r = pixels[i].R, g = pixels[i].G, b = pixels[i].B;
+                yuv[i] = (byte)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                yuv[plane + i] = (byte)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                yuv[2 * plane + i] = (byte)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+
+        // Drains what is already queued, then closes the output
+        public void Dispose()
+        {
+            _queue.Writer.TryComplete();
+            Task.WaitAll(_workers);
+            _stream?.Dispose();
+        }
+    }
+}
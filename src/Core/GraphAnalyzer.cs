@@ -0,0 +1,132 @@
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace ToyConEngine
+{
+    public sealed class GraphAnalysis
+    {
+        public HashSet<Node> Live { get; } = new HashSet<Node>();
+        // Nothing visible is downstream of these; the compiled plan can skip them
+        public List<Node> Dead { get; } = new List<Node>();
+        // Pure nodes whose inputs are all constants
+        public List<Node> ConstantFoldable { get; } = new List<Node>();
+        // Pure nodes computing exactly what an earlier node already computes
+        public List<(Node Duplicate, Node Original)> Duplicates { get; } = new List<(Node, Node)>();
+        // Extra wires into a port from a source (or a duplicate of one) that is already connected
+        public int RedundantWires { get; set; }
+
+        public override string ToString()
+        {
+            var sb = new StringBuilder();
+            sb.AppendLine($"{Live.Count} live, {Dead.Count} dead nodes");
+            sb.AppendLine($"{ConstantFoldable.Count} constant-foldable");
+            sb.AppendLine($"{Duplicates.Count} duplicate nodes");
+            sb.Append($"{RedundantWires} redundant wires");
+            return sb.ToString();
+        }
+    }
+
+    // Static checks over a graph. Liveness runs backwards from the sinks, the nodes whose
+    // effect is visible outside the graph; everything else only costs Evaluate time.
+    public static class GraphAnalyzer
+    {
+        public static bool IsSink(Node node) =>
+            node is ColorOutputNode || node is ScreenNode || node is BeepOutputNode ||
+            node is ToyOutputNode || node is SharedOutputNode || node is ToyNode;
+
+        // Output depends only on the inputs and settings: no state, time or outside input
+        public static bool IsPure(Node node) =>
+            node is ConstantNode || node is MathNode || node is LogicNode || node is AggregateNode;
+
+        // With keepState, every node that is not pure is a root too, together with what
+        // feeds it: skipping a timer, counter or random node would freeze its state, so only
+        // pure nodes can be dropped without changing what the design does later
+        public static HashSet<Node> FindLive(List<Node> nodes, bool keepState = false)
+        {
+            var members = new HashSet<Node>(nodes);
+            var live = new HashSet<Node>();
+            var stack = new Stack<Node>();
+            foreach (var node in nodes)
+            {
+                if ((IsSink(node) || keepState && !IsPure(node)) && live.Add(node)) stack.Push(node);
+            }
+
+            while (stack.Count > 0)
+            {
+                foreach (var input in stack.Pop().Inputs)
+                {
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        var n = source.ParentNode;
+                        if (members.Contains(n) && live.Add(n)) stack.Push(n);
+                    }
+                }
+            }
+            return live;
+        }
+
+        public static GraphAnalysis Analyze(List<Node> nodes)
+        {
+            var result = new GraphAnalysis();
+            result.Live.UnionWith(FindLive(nodes));
+            foreach (var node in nodes) if (!result.Live.Contains(node)) result.Dead.Add(node);
+
+            // Value numbering in dependency order: a pure node is a duplicate when an earlier
+            // node has the same type, settings and (canonical) sources on every port.
+            var levels = new Dictionary<Node, int>();
+            var ordered = ExecutionPlan.ComputeLevels(nodes, levels).SelectMany(l => l).Where(n => levels[n] >= 0);
+
+            var number = new Dictionary<Node, int>();
+            var canonical = new Dictionary<Node, Node>();
+            var seen = new Dictionary<string, Node>();
+            var constant = new HashSet<Node>();
+            var key = new StringBuilder();
+
+            foreach (var node in ordered)
+            {
+                number[node] = number.Count;
+                canonical[node] = node;
+
+                bool allConstant = true;
+                bool comparable = true;
+                key.Clear();
+                key.Append(node.GetType().Name).Append('|').Append(DesignLoader.GetNodeData(node));
+
+                foreach (var input in node.Inputs)
+                {
+                    // Ports take the max of their wires, so order does not matter and repeats add nothing
+                    var sources = new SortedSet<(int, int)>();
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        var parent = source.ParentNode;
+                        // Sources in a feedback loop have no number yet
+                        if (!canonical.TryGetValue(parent, out var c)) { allConstant = false; comparable = false; continue; }
+                        if (!sources.Add((number[c], parent.Outputs.IndexOf(source)))) result.RedundantWires++;
+                        if (!constant.Contains(parent)) allConstant = false;
+                    }
+                    key.Append('|');
+                    foreach (var (n, slot) in sources) key.Append(n).Append(':').Append(slot).Append(',');
+                }
+
+                if (!IsPure(node)) continue;
+
+                if (node is ConstantNode || allConstant)
+                {
+                    constant.Add(node);
+                    if (!(node is ConstantNode)) result.ConstantFoldable.Add(node);
+                }
+
+                if (!comparable) continue;
+                string k = key.ToString();
+                if (seen.TryGetValue(k, out var original))
+                {
+                    canonical[node] = original;
+                    result.Duplicates.Add((node, original));
+                }
+                else seen[k] = node;
+            }
+            return result;
+        }
+    }
+}
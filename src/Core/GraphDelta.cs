@@ -0,0 +1,197 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace ToyConEngine
+{
+    // Difference between two snapshots of the same design, keyed by stable node IDs.
+    // Stored in a compact binary patch file; applying it to a live graph touches only
+    // the nodes and wires it names. The patch records the structure hash of the snapshot it
+    // was made from, and is refused by a graph whose structure is different, since its IDs
+    // would then name other nodes.
+    public sealed class GraphDelta
+    {
+        public static readonly byte[] Magic = Encoding.ASCII.GetBytes("TOYCONP2");
+        // Patches from before the base hash; applied with only the ID collision check
+        public static readonly byte[] MagicV1 = Encoding.ASCII.GetBytes("TOYCONP1");
+
+        // GraphSnapshot.StructureHash of the base; 0 when unknown (an old patch)
+        public ulong BaseHash { get; private set; }
+
+        public List<GraphSnapshot.NodeRecord> AddedNodes { get; } = new List<GraphSnapshot.NodeRecord>();
+        public List<GraphSnapshot.NodeRecord> ChangedNodes { get; } = new List<GraphSnapshot.NodeRecord>();
+        public List<int> RemovedNodes { get; } = new List<int>();
+        public List<GraphSnapshot.ConnectionRecord> AddedConnections { get; } = new List<GraphSnapshot.ConnectionRecord>();
+        public List<GraphSnapshot.ConnectionRecord> RemovedConnections { get; } = new List<GraphSnapshot.ConnectionRecord>();
+
+        public bool IsEmpty => AddedNodes.Count == 0 && ChangedNodes.Count == 0 && RemovedNodes.Count == 0 && AddedConnections.Count == 0 && RemovedConnections.Count == 0;
+
+        public static GraphDelta Compute(GraphSnapshot from, GraphSnapshot to)
+        {
+            var delta = new GraphDelta { BaseHash = from.StructureHash() };
+
+            var old = new Dictionary<int, GraphSnapshot.NodeRecord>(from.Nodes.Length);
+            foreach (var n in from.Nodes) old[n.Id] = n;
+
+            var seen = new HashSet<int>();
+            foreach (var n in to.Nodes)
+            {
+                seen.Add(n.Id);
+                if (!old.TryGetValue(n.Id, out var o) || o.Type != n.Type) 
+                {
+                    // A different type under the same ID is a replacement
+                    if (old.ContainsKey(n.Id)) delta.RemovedNodes.Add(n.Id);
+                    delta.AddedNodes.Add(n);
+                }
+                else if (o.X != n.X || o.Y != n.Y || o.Data != n.Data) delta.ChangedNodes.Add(n);
+            }
+            foreach (var n in from.Nodes) if (!seen.Contains(n.Id)) delta.RemovedNodes.Add(n.Id);
+
+            var oldConns = new HashSet<GraphSnapshot.ConnectionRecord>(from.Connections);
+            var newConns = new HashSet<GraphSnapshot.ConnectionRecord>(to.Connections);
+            foreach (var c in to.Connections) if (!oldConns.Contains(c)) delta.AddedConnections.Add(c);
+            foreach (var c in from.Connections) if (!newConns.Contains(c)) delta.RemovedConnections.Add(c);
+
+            return delta;
+        }
+
+        // Whether this patch was made against a graph with the current one's structure
+        public bool Fits(GraphSnapshot current) => BaseHash == 0 || BaseHash == current.StructureHash();
+
+        // Order matters: wires go before the nodes they hang off, new nodes before new wires.
+        // createNode builds an empty node of a type name, applyData restores its settings.
+        // Throws InvalidDataException, before changing anything, when an added node's ID is
+        // held by a node the patch does not remove.
+        public void ApplyTo(GraphEngine engine, Dictionary<Node, Rectangle> rects, Func<GraphSnapshot.NodeRecord, Node> createNode, Action<Node, string> applyData)
+        {
+            var removed = new HashSet<int>(RemovedNodes);
+            foreach (var n in AddedNodes)
+            {
+                if (engine.FindNode(n.Id) != null && !removed.Contains(n.Id))
+                    throw new InvalidDataException($"Patch adds node {n.Id}, which this design already has");
+            }
+
+            foreach (var c in RemovedConnections)
+            {
+                var source = engine.FindNode(c.SourceId);
+                var target = engine.FindNode(c.TargetId);
+                if (source == null || target == null || c.SourceSlot >= source.Outputs.Count || c.TargetSlot >= target.Inputs.Count) continue;
+                target.Inputs[c.TargetSlot].ConnectedSources.Remove(source.Outputs[c.SourceSlot]);
+            }
+
+            foreach (int id in RemovedNodes)
+            {
+                var node = engine.FindNode(id);
+                if (node == null) continue;
+                engine.RemoveNode(node);
+                rects?.Remove(node);
+            }
+
+            foreach (var n in AddedNodes)
+            {
+                var node = createNode(n);
+                if (node == null) continue;
+                node.Id = n.Id;
+                applyData(node, n.Data);
+                engine.AddNode(node);
+            }
+
+            foreach (var n in ChangedNodes)
+            {
+                var node = engine.FindNode(n.Id);
+                if (node == null) continue;
+                applyData(node, n.Data);
+                if (rects != null && rects.TryGetValue(node, out var r)) rects[node] = new Rectangle(n.X, n.Y, r.Width, r.Height);
+            }
+
+            foreach (var c in AddedConnections)
+            {
+                var source = engine.FindNode(c.SourceId);
+                var target = engine.FindNode(c.TargetId);
+                if (source == null || target == null || c.SourceSlot >= source.Outputs.Count || c.TargetSlot >= target.Inputs.Count) continue;
+                engine.Connect(source, c.SourceSlot, target, c.TargetSlot);
+            }
+
+            engine.Invalidate();
+        }
+
+        public void Write(Stream stream)
+        {
+            using var writer = new BinaryWriter(stream, Encoding.UTF8, true);
+            writer.Write(Magic);
+            writer.Write(BaseHash);
+
+            WriteNodes(writer, AddedNodes);
+            WriteNodes(writer, ChangedNodes);
+            writer.Write7BitEncodedInt(RemovedNodes.Count);
+            foreach (int id in RemovedNodes) writer.Write7BitEncodedInt(id);
+            WriteConnections(writer, AddedConnections);
+            WriteConnections(writer, RemovedConnections);
+        }
+
+        public static GraphDelta Read(Stream stream)
+        {
+            using var reader = new BinaryReader(stream, Encoding.UTF8, true);
+            var magic = reader.ReadBytes(Magic.Length);
+            bool v1 = magic.AsSpan().SequenceEqual(MagicV1);
+            if (!v1 && !magic.AsSpan().SequenceEqual(Magic)) throw new InvalidDataException("Not a ToyCon patch file");
+
+            var delta = new GraphDelta();
+            if (!v1) delta.BaseHash = reader.ReadUInt64();
+            ReadNodes(reader, delta.AddedNodes);
+            ReadNodes(reader, delta.ChangedNodes);
+            int removed = reader.Read7BitEncodedInt();
+            for (int i = 0; i < removed; i++) delta.RemovedNodes.Add(reader.Read7BitEncodedInt());
+            ReadConnections(reader, delta.AddedConnections);
+            ReadConnections(reader, delta.RemovedConnections);
+            return delta;
+        }
+
+        private static void WriteNodes(BinaryWriter writer, List<GraphSnapshot.NodeRecord> nodes)
+        {
+            writer.Write7BitEncodedInt(nodes.Count);
+            foreach (var n in nodes)
+            {
+                writer.Write7BitEncodedInt(n.Id);
+                writer.Write(n.Type);
+                writer.Write(n.X);
+                writer.Write(n.Y);
+                writer.Write(n.Data ?? "");
+            }
+        }
+
+        private static void ReadNodes(BinaryReader reader, List<GraphSnapshot.NodeRecord> nodes)
+        {
+            int count = reader.Read7BitEncodedInt();
+            for (int i = 0; i < count; i++)
+            {
+                int id = reader.Read7BitEncodedInt();
+                string type = reader.ReadString();
+                int x = reader.ReadInt32();
+                int y = reader.ReadInt32();
+                nodes.Add(new GraphSnapshot.NodeRecord(id, type, x, y, reader.ReadString()));
+            }
+        }
+
+        private static void WriteConnections(BinaryWriter writer, List<GraphSnapshot.ConnectionRecord> connections)
+        {
+            writer.Write7BitEncodedInt(connections.Count);
+            foreach (var c in connections)
+            {
+                writer.Write7BitEncodedInt(c.SourceId);
+                writer.Write7BitEncodedInt(c.SourceSlot);
+                writer.Write7BitEncodedInt(c.TargetId);
+                writer.Write7BitEncodedInt(c.TargetSlot);
+            }
+        }
+
+        private static void ReadConnections(BinaryReader reader, List<GraphSnapshot.ConnectionRecord> connections)
+        {
+            int count = reader.Read7BitEncodedInt();
+            for (int i = 0; i < count; i++)
+                connections.Add(new GraphSnapshot.ConnectionRecord(reader.Read7BitEncodedInt(), reader.Read7BitEncodedInt(), reader.Read7BitEncodedInt(), reader.Read7BitEncodedInt()));
+        }
+    }
+}
@@ -0,0 +1,168 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // Layered (Sugiyama-style) auto layout. Columns are the topological levels of the
+    // execution plan, the order inside a column is improved with barycenter sweeps until
+    // the time budget runs out, then rows are packed so edges run as straight as possible.
+    // Capture() snapshots the graph on the UI thread; Compute() only touches the snapshot
+    // so it can run on a worker.
+    public sealed class GraphLayout
+    {
+        public const int OriginX = 100;
+        public const int OriginY = 100;
+        public const int ColumnGap = 80;
+        public const int RowGap = 20;
+        public static readonly TimeSpan Budget = TimeSpan.FromMilliseconds(60);
+
+        private Node[] _nodes;
+        private Rectangle[] _rects;
+        private int[] _level;
+        private int[][] _preds;
+        private int[][] _succs;
+
+        public static GraphLayout Capture(GraphEngine engine, Dictionary<Node, Rectangle> rects)
+        {
+            var nodes = new List<Node>();
+            foreach (var n in engine.Nodes) if (rects.ContainsKey(n)) nodes.Add(n);
+
+            var layout = new GraphLayout
+            {
+                _nodes = nodes.ToArray(),
+                _rects = new Rectangle[nodes.Count],
+                _level = new int[nodes.Count],
+                _preds = new int[nodes.Count][],
+                _succs = new int[nodes.Count][]
+            };
+
+            var index = new Dictionary<Node, int>(nodes.Count);
+            for (int i = 0; i < nodes.Count; i++) index[nodes[i]] = i;
+
+            var levels = engine.Plan.NodeLevels;
+            int maxLevel = 0;
+            foreach (var n in nodes) if (levels.TryGetValue(n, out int l) && l > maxLevel) maxLevel = l;
+
+            var preds = new List<int>[nodes.Count];
+            var succs = new List<int>[nodes.Count];
+            for (int i = 0; i < nodes.Count; i++) { preds[i] = new List<int>(); succs[i] = new List<int>(); }
+
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                layout._rects[i] = rects[nodes[i]];
+                // Feedback loops have no level; put them in a column after everything else
+                layout._level[i] = levels.TryGetValue(nodes[i], out int l) && l >= 0 ? l : maxLevel + 1;
+
+                foreach (var input in nodes[i].Inputs)
+                {
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        if (!index.TryGetValue(source.ParentNode, out int src) || src == i) continue;
+                        preds[i].Add(src);
+                        succs[src].Add(i);
+                    }
+                }
+            }
+
+            for (int i = 0; i < nodes.Count; i++) { layout._preds[i] = preds[i].ToArray(); layout._succs[i] = succs[i].ToArray(); }
+            return layout;
+        }
+
+        public Task<Dictionary<Node, Point>> RunAsync(bool incremental) => Task.Run(() => Compute(incremental));
+
+        // Incremental runs keep the current vertical order as the starting point and
+        // only polish it, so a small edit does not reshuffle the whole design.
+        public Dictionary<Node, Point> Compute(bool incremental)
+        {
+            var sw = Stopwatch.StartNew();
+            int count = _nodes.Length;
+            var result = new Dictionary<Node, Point>(count);
+            if (count == 0) return result;
+
+            int levelCount = 0;
+            foreach (int l in _level) if (l + 1 > levelCount) levelCount = l + 1;
+
+            // Initial order inside each column: current Y, so both modes start from what the user sees
+            var layers = new List<int>[levelCount];
+            for (int l = 0; l < levelCount; l++) layers[l] = new List<int>();
+            for (int i = 0; i < count; i++) layers[_level[i]].Add(i);
+            foreach (var layer in layers) layer.Sort((a, b) => _rects[a].Y != _rects[b].Y ? _rects[a].Y.CompareTo(_rects[b].Y) : a.CompareTo(b));
+
+            var rank = new float[count];
+            var key = new float[count];
+            UpdateRanks(layers, rank);
+
+            int maxSweeps = incremental ? 4 : 32;
+            for (int sweep = 0; sweep < maxSweeps && sw.Elapsed < Budget; sweep++)
+            {
+                bool down = sweep % 2 == 0;
+                for (int step = 1; step < levelCount; step++)
+                {
+                    int l = down ? step : levelCount - 1 - step;
+                    Reorder(layers[l], down ? _preds : _succs, rank, key);
+                    UpdateRanks(layers[l], rank);
+                }
+            }
+
+            // Columns sized to their widest node, rows packed towards the predecessors' centre
+            int x = OriginX;
+            var centerY = new float[count];
+            for (int l = 0; l < levelCount; l++)
+            {
+                int width = 0;
+                int nextTop = OriginY;
+                foreach (int i in layers[l])
+                {
+                    var r = _rects[i];
+                    if (r.Width > width) width = r.Width;
+
+                    int top = nextTop;
+                    if (_preds[i].Length > 0)
+                    {
+                        float sum = 0;
+                        foreach (int p in _preds[i]) sum += centerY[p];
+                        top = Math.Max(nextTop, (int)(sum / _preds[i].Length - r.Height / 2f));
+                    }
+
+                    centerY[i] = top + r.Height / 2f;
+                    nextTop = top + r.Height + RowGap;
+                    result[_nodes[i]] = new Point(x, top);
+                }
+                x += width + ColumnGap;
+            }
+            return result;
+        }
+
+        private static void UpdateRanks(List<int>[] layers, float[] rank)
+        {
+            foreach (var layer in layers) UpdateRanks(layer, rank);
+        }
+
+        // Position normalized to 0-1 so columns of different heights are comparable
+        private static void UpdateRanks(List<int> layer, float[] rank)
+        {
+            for (int j = 0; j < layer.Count; j++) rank[layer[j]] = (j + 0.5f) / layer.Count;
+        }
+
+        private static void Reorder(List<int> layer, int[][] neighbours, float[] rank, float[] key)
+        {
+            foreach (int i in layer)
+            {
+                var adj = neighbours[i];
+                if (adj.Length == 0) { key[i] = rank[i]; continue; }
+                float sum = 0;
+                foreach (int n in adj) sum += rank[n];
+                key[i] = sum / adj.Length;
+            }
+            // Ties keep their current order so repeated runs converge instead of flipping nodes
+            layer.Sort((a, b) =>
+            {
+                int c = key[a].CompareTo(key[b]);
+                return c != 0 ? c : rank[a].CompareTo(rank[b]);
+            });
+        }
+    }
+}
@@ -1,30 +1,179 @@
 using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Threading;
 
 //The Graph Manager (The Engine)
 namespace ToyConEngine {
     public class GraphEngine
     {
         public List<Node> Nodes { get; set; } = new List<Node>();
+        public long TickCount { get; private set; }
+
+        // Raised before every tick (input sources) and after it, while the graph is consistent (output sinks)
+        public event Action<GraphEngine> Ticking;
+        public event Action<GraphEngine> Ticked;
+
+        private ExecutionPlan _plan;
+        private int _planNodeCount;
+        private bool _pruneDeadNodes;
+
+        // Leave pure nodes that nothing visible or stateful depends on out of the compiled plan.
+        // The node list is untouched, but pruned nodes stop updating, so the editor only turns
+        // this on when the graph is not being edited.
+        public bool PruneDeadNodes
+        {
+            get => _pruneDeadNodes;
+            set { if (_pruneDeadNodes != value) { _pruneDeadNodes = value; Invalidate(); } }
+        }
+
+        // Set by PartitionedRunner: only these nodes are evaluated, the rest are fed from other processes
+        private Predicate<Node> _owned;
+        public Predicate<Node> Owned
+        {
+            get => _owned;
+            set { _owned = value; Invalidate(); }
+        }
+
+        // Structural edits posted from any thread, applied together at the next tick start.
+        // Each one only invalidates the plan, so a batch costs a single recompile.
+        private readonly MpscQueue<Action<GraphEngine>> _edits = new MpscQueue<Action<GraphEngine>>();
+        public long EditsApplied { get; private set; }
+        // Edits that threw; the rest of their batch is still applied
+        public long EditsFailed { get; private set; }
+        public Exception LastEditError { get; private set; }
+
+        // AsyncNodes whose operation finished on the thread pool, published at the next tick start
+        private readonly ConcurrentQueue<AsyncNode> _completions = new ConcurrentQueue<AsyncNode>();
+        private int _asyncRunning;
+
+        // Async operations started and not yet published, so a host knows more output is coming
+        public bool HasAsyncWork => Volatile.Read(ref _asyncRunning) > 0;
+
+        // The engine ticking on this thread (the innermost one inside a ToyNode), so nodes
+        // can find the engine they run in without holding a reference to it
+        [ThreadStatic] private static GraphEngine _current;
+        public static GraphEngine Current => _current;
+
+        // Id -> node, kept up to date by AddNode/RemoveNode/Clear so deltas apply without a scan
+        private readonly Dictionary<int, Node> _byId = new Dictionary<int, Node>();
+        private int _nextId = 1;
+
+        public ExecutionPlan Plan
+        {
+            get
+            {
+                // Nodes is edited directly by the editor, so a count change also means a stale plan
+                if (_plan == null || _planNodeCount != Nodes.Count)
+                {
+                    _plan = ExecutionPlan.Compile(Nodes, _pruneDeadNodes, _owned);
+                    _planNodeCount = Nodes.Count;
+                }
+                return _plan;
+            }
+        }
+
+        // Call after changing wiring, node list or a MathNode's Op
+        public void Invalidate() => _plan = null;
+
+        // Keeps the node's Id when it is free (loaded designs), otherwise allocates a new one
+        public void AddNode(Node node)
+        {
+            if (node.Id <= 0 || _byId.ContainsKey(node.Id)) node.Id = _nextId;
+            if (node.Id >= _nextId) _nextId = node.Id + 1;
+            _byId[node.Id] = node;
+            Nodes.Add(node);
+            Invalidate();
+        }
+
+        public void RemoveNode(Node node)
+        {
+            if (_byId.TryGetValue(node.Id, out var n) && n == node) _byId.Remove(node.Id);
+            if (node is AsyncNode async) async.Cancel();
+            Nodes.Remove(node);
+            Invalidate();
+        }
+
+        public void Clear()
+        {
+            foreach (var node in Nodes) if (node is AsyncNode async) async.Cancel();
+            Nodes.Clear();
+            _byId.Clear();
+            _nextId = 1;
+            Invalidate();
+        }
+
+        // For value edits that do not change the wiring: only the folded region below the constant is recomputed
+        public void ConstantChanged(ConstantNode node) => Plan.Respecialize(node);
+
+        internal void AsyncStarted() => Interlocked.Increment(ref _asyncRunning);
+
+        internal void PostCompletion(AsyncNode node) => _completions.Enqueue(node);
+
+        // Queues a change to the graph (wiring, node list, node structure) for the next tick
+        // boundary instead of making it while the engine may be iterating
+        public void Post(Action<GraphEngine> edit) => _edits.Enqueue(edit);
+
+        // Applies the posted edits now; Tick does this first, so only call it from the thread that ticks
+        public int ApplyEdits()
+        {
+            int applied = 0;
+            while (_edits.TryDequeue(out var edit))
+            {
+                try
+                {
+                    edit(this);
+                    applied++;
+                }
+                catch (Exception ex)
+                {
+                    // One bad edit must not leave the ones queued behind it waiting, or stop the tick
+                    EditsFailed++;
+                    LastEditError = ex;
+                    Invalidate();
+                }
+            }
+            EditsApplied += applied;
+            return applied;
+        }
+
+        public Node FindNode(int id) => _byId.TryGetValue(id, out var n) ? n : null;
 
         public void Connect(Node sourceNode, int sourceIndex, Node targetNode, int targetIndex)
         {
             var sourcePort = sourceNode.Outputs[sourceIndex];
             var targetPort = targetNode.Inputs[targetIndex];
             if (!targetPort.ConnectedSources.Contains(sourcePort))
+            {
                 targetPort.ConnectedSources.Add(sourcePort);
+                Invalidate();
+            }
         }
 
         // The "Game Loop"
-        public void Tick(GameTime gameTime)
+        public void Tick(GameTime gameTime, Action<int> afterLevel = null)
         {
-            // In a real engine, you need to sort nodes by dependency (Topological Sort)
-            // or run multiple passes to propagate signals correctly.
-            // For simplicity, we iterate linearly here.
-            foreach (var node in Nodes)
+            // Nodes run level by level in dependency order (see ExecutionPlan)
+            var outer = _current;
+            _current = this;
+            try
+            {
+                if (!_edits.IsEmpty) ApplyEdits();
+                Ticking?.Invoke(this);
+                while (_completions.TryDequeue(out var node))
+                {
+                    Interlocked.Decrement(ref _asyncRunning);
+                    node.Publish();
+                }
+                Plan.Run(gameTime, afterLevel);
+                TickCount++;
+                Ticked?.Invoke(this);
+            }
+            finally
             {
-                node.Evaluate(gameTime);
+                _current = outer;
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,206 @@
+using System;
+using System.Collections.Generic;
+
+namespace ToyConEngine
+{
+    // Splits the scheduled nodes of a design into balanced partitions with few wires between
+    // them, since every cut wire costs one shared-memory slot and a barrier per tick.
+    // The result depends only on the node list and wiring, so every worker process
+    // computes the same partition from the same design without talking to the others.
+    public static class GraphPartitioner
+    {
+        // Refinement may overfill a partition by this much to save a cut wire
+        public const float Slack = 0.05f;
+        private const int RefinePasses = 4;
+
+        // `nodes` are the nodes the plan schedules, in node-list order; `levels` are their plan levels
+        public static Dictionary<Node, int> Partition(List<Node> nodes, int count, Dictionary<Node, int> levels)
+        {
+            var result = new Dictionary<Node, int>(nodes.Count);
+            if (count <= 1 || nodes.Count == 0)
+            {
+                foreach (var n in nodes) result[n] = 0;
+                return result;
+            }
+
+            var index = new Dictionary<Node, int>(nodes.Count);
+            for (int i = 0; i < nodes.Count; i++) index[nodes[i]] = i;
+
+            // Undirected adjacency, one entry per wire, in a fixed order
+            var adj = new List<int>[nodes.Count];
+            for (int i = 0; i < nodes.Count; i++) adj[i] = new List<int>();
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                foreach (var input in nodes[i].Inputs)
+                {
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        if (!index.TryGetValue(source.ParentNode, out int src) || src == i) continue;
+                        adj[i].Add(src);
+                        adj[src].Add(i);
+                    }
+                }
+            }
+
+            var weight = new int[nodes.Count];
+            long total = 0;
+            for (int i = 0; i < nodes.Count; i++) { weight[i] = Weight(nodes[i]); total += weight[i]; }
+            long target = (total + count - 1) / count;
+
+            var part = new int[nodes.Count];
+            var load = new long[count];
+            Array.Fill(part, -1);
+
+            // Feedback loops run in list order in one place, so they all stay on partition 0
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                if (levels.TryGetValue(nodes[i], out int l) && l < 0) { part[i] = 0; load[0] += weight[i]; }
+            }
+
+            // Connected components, heaviest first; whole components go to the lightest partition
+            var components = Components(adj, weight, part);
+            components.Sort((a, b) => a.Weight != b.Weight ? b.Weight.CompareTo(a.Weight) : a.Members[0].CompareTo(b.Members[0]));
+
+            foreach (var component in components)
+            {
+                int lightest = Lightest(load);
+                if (load[lightest] + component.Weight <= target + target * Slack)
+                {
+                    foreach (int i in component.Members) part[i] = lightest;
+                    load[lightest] += component.Weight;
+                    continue;
+                }
+
+                // Too big for one partition: grow regions one node at a time, always taking the
+                // frontier node with the most wires into the region (earliest level first on ties),
+                // so regions follow chains instead of cutting across them at a hub
+                var order = new List<int>(component.Members);
+                order.Sort((a, b) => Earlier(nodes, levels, a, b));
+
+                int cursor = 0, remaining = order.Count;
+                var gain = new Dictionary<int, int>();
+                var frontier = new SortedSet<(int Gain, int Level, int Index)>();
+                while (remaining > 0)
+                {
+                    int current = Lightest(load);
+                    gain.Clear();
+                    frontier.Clear();
+                    do
+                    {
+                        if (frontier.Count == 0)
+                        {
+                            while (part[order[cursor]] >= 0) cursor++;
+                            frontier.Add((0, levels[nodes[order[cursor]]], order[cursor]));
+                        }
+
+                        var next = frontier.Min;
+                        frontier.Remove(next);
+                        int i = next.Index;
+                        part[i] = current;
+                        load[current] += weight[i];
+                        remaining--;
+
+                        foreach (int j in adj[i])
+                        {
+                            if (part[j] >= 0) continue;
+                            gain.TryGetValue(j, out int g);
+                            frontier.Remove((-g, levels[nodes[j]], j));
+                            gain[j] = g + 1;
+                            frontier.Add((-g - 1, levels[nodes[j]], j));
+                        }
+                    }
+                    while (remaining > 0 && load[current] < target);
+                }
+            }
+
+            Refine(nodes, levels, adj, weight, part, load, target);
+
+            for (int i = 0; i < nodes.Count; i++) result[nodes[i]] = part[i];
+            return result;
+        }
+
+        // A nested design costs about as much as everything inside it
+        public static int Weight(Node node) => node is ToyNode toy ? 1 + toy.InternalEngine.Nodes.Count : 1;
+
+        private sealed class Component
+        {
+            public List<int> Members = new List<int>();
+            public long Weight;
+        }
+
+        private static List<Component> Components(List<int>[] adj, int[] weight, int[] part)
+        {
+            int count = adj.Length;
+            var components = new List<Component>();
+            var seen = new bool[count];
+            var stack = new Stack<int>();
+            for (int start = 0; start < count; start++)
+            {
+                if (seen[start] || part[start] >= 0) continue;
+                var component = new Component();
+                seen[start] = true;
+                stack.Push(start);
+                while (stack.Count > 0)
+                {
+                    int i = stack.Pop();
+                    component.Members.Add(i);
+                    component.Weight += weight[i];
+                    foreach (int j in adj[i])
+                    {
+                        if (seen[j] || part[j] >= 0) continue;
+                        seen[j] = true;
+                        stack.Push(j);
+                    }
+                }
+                component.Members.Sort();
+                components.Add(component);
+            }
+            return components;
+        }
+
+        // Moves boundary nodes to the neighbouring partition they have the most wires into,
+        // as long as that does not overfill it. Pinned feedback nodes never move.
+        private static void Refine(List<Node> nodes, Dictionary<Node, int> levels, List<int>[] adj, int[] weight, int[] part, long[] load, long target)
+        {
+            var links = new int[load.Length];
+            long limit = target + (long)(target * Slack);
+            for (int pass = 0; pass < RefinePasses; pass++)
+            {
+                bool moved = false;
+                for (int i = 0; i < nodes.Count; i++)
+                {
+                    if (levels[nodes[i]] < 0 || adj[i].Count == 0) continue;
+
+                    Array.Clear(links, 0, links.Length);
+                    foreach (int j in adj[i]) links[part[j]]++;
+
+                    int from = part[i], best = from;
+                    for (int p = 0; p < links.Length; p++)
+                    {
+                        if (links[p] > links[best] && load[p] + weight[i] <= limit) best = p;
+                    }
+                    if (best == from) continue;
+
+                    part[i] = best;
+                    load[from] -= weight[i];
+                    load[best] += weight[i];
+                    moved = true;
+                }
+                if (!moved) break;
+            }
+        }
+
+        private static int Earlier(List<Node> nodes, Dictionary<Node, int> levels, int a, int b)
+        {
+            int la = levels[nodes[a]], lb = levels[nodes[b]];
+            return la != lb ? la.CompareTo(lb) : a.CompareTo(b);
+        }
+
+        private static int Lightest(long[] load)
+        {
+            int best = 0;
+            for (int p = 1; p < load.Length; p++) if (load[p] < load[best]) best = p;
+            return best;
+        }
+    }
+}
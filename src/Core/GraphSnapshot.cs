@@ -0,0 +1,154 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace ToyConEngine
+{
+    // Immutable copy of everything a design file needs. Capturing only copies plain
+    // values, so it is cheap enough for the UI thread at a tick boundary; turning it
+    // into text can then happen on any thread while the live graph keeps changing.
+    public sealed class GraphSnapshot
+    {
+        public const string Header = "TOYCON_v1";
+
+        public readonly struct NodeRecord
+        {
+            public readonly int Id;
+            public readonly string Type;
+            public readonly int X, Y;
+            public readonly string Data;
+            // Raw settings of a CaptureState snapshot, until WithData formats them
+            public readonly NodeState State;
+
+            public NodeRecord(int id, string type, int x, int y, string data, NodeState state = default)
+            {
+                Id = id; Type = type; X = x; Y = y; Data = data; State = state;
+            }
+        }
+
+        public readonly struct ConnectionRecord : IEquatable<ConnectionRecord>
+        {
+            public readonly int SourceId, SourceSlot, TargetId, TargetSlot;
+
+            public ConnectionRecord(int sourceId, int sourceSlot, int targetId, int targetSlot)
+            {
+                SourceId = sourceId; SourceSlot = sourceSlot; TargetId = targetId; TargetSlot = targetSlot;
+            }
+
+            public bool Equals(ConnectionRecord o) => SourceId == o.SourceId && SourceSlot == o.SourceSlot && TargetId == o.TargetId && TargetSlot == o.TargetSlot;
+            public override bool Equals(object obj) => obj is ConnectionRecord o && Equals(o);
+            public override int GetHashCode() => HashCode.Combine(SourceId, SourceSlot, TargetId, TargetSlot);
+        }
+
+        // Where presentation mode shows a node (PresentationLayout), in canvas coordinates
+        public readonly struct ViewRecord
+        {
+            public readonly int Id;
+            public readonly Rectangle Rect;
+
+            public ViewRecord(int id, Rectangle rect) { Id = id; Rect = rect; }
+        }
+
+        public static readonly GraphSnapshot Empty = new GraphSnapshot { Nodes = new NodeRecord[0], Connections = new ConnectionRecord[0], Views = new ViewRecord[0] };
+
+        public NodeRecord[] Nodes { get; private set; }
+        public ConnectionRecord[] Connections { get; private set; }
+        public ViewRecord[] Views { get; private set; }
+
+        public static GraphSnapshot Capture(GraphEngine engine, Dictionary<Node, Rectangle> rects, Func<Node, string> getData, PresentationLayout layout = null) =>
+            Capture(engine, rects, (node, r) => new NodeRecord(node.Id, node.GetType().Name, r.X, r.Y, getData(node)), layout);
+
+        // Copies settings raw instead of as text, for big designs at a tick boundary; Data is
+        // filled in later by WithData, off the UI thread
+        public static GraphSnapshot CaptureState(GraphEngine engine, Dictionary<Node, Rectangle> rects, Func<Node, NodeState> getState, PresentationLayout layout = null) =>
+            Capture(engine, rects, (node, r) => new NodeRecord(node.Id, node.GetType().Name, r.X, r.Y, null, getState(node)), layout);
+
+        public GraphSnapshot WithData(Func<string, NodeState, string> format)
+        {
+            var records = new NodeRecord[Nodes.Length];
+            for (int i = 0; i < records.Length; i++)
+            {
+                var n = Nodes[i];
+                records[i] = new NodeRecord(n.Id, n.Type, n.X, n.Y, n.Data ?? format(n.Type, n.State));
+            }
+            return new GraphSnapshot { Nodes = records, Connections = Connections, Views = Views };
+        }
+
+        private static GraphSnapshot Capture(GraphEngine engine, Dictionary<Node, Rectangle> rects, Func<Node, Rectangle, NodeRecord> record, PresentationLayout layout)
+        {
+            var nodes = engine.Nodes;
+            var records = new NodeRecord[nodes.Count];
+            var connections = new List<ConnectionRecord>();
+
+            // Node IDs are the engine's stable ones, so unchanged nodes keep their lines between saves
+            var present = new HashSet<Node>(nodes);
+
+            for (int i = 0; i < nodes.Count; i++)
+            {
+                var node = nodes[i];
+                records[i] = record(node, rects[node]);
+
+                for (int slot = 0; slot < node.Inputs.Count; slot++)
+                {
+                    foreach (var source in node.Inputs[slot].ConnectedSources)
+                    {
+                        if (!present.Contains(source.ParentNode)) continue;
+                        connections.Add(new ConnectionRecord(source.ParentNode.Id, source.ParentNode.Outputs.IndexOf(source), node.Id, slot));
+                    }
+                }
+            }
+
+            var views = new List<ViewRecord>();
+            if (layout != null)
+            {
+                foreach (var node in nodes)
+                    if (layout.Placed.TryGetValue(node, out var view)) views.Add(new ViewRecord(node.Id, view));
+            }
+
+            return new GraphSnapshot { Nodes = records, Connections = connections.ToArray(), Views = views.ToArray() };
+        }
+
+        // Identifies the design's structure (node IDs and types, and wiring), ignoring positions
+        // and settings, so a patch can check it is applied to the graph it was made against
+        public ulong StructureHash()
+        {
+            ulong hash = 14695981039346656037UL;
+            void Mix(int value)
+            {
+                for (int i = 0; i < 4; i++) { hash ^= (byte)(value >> (i * 8)); hash *= 1099511628211UL; }
+            }
+
+            var nodes = (NodeRecord[])Nodes.Clone();
+            Array.Sort(nodes, (a, b) => a.Id.CompareTo(b.Id));
+            foreach (var n in nodes)
+            {
+                Mix(n.Id);
+                foreach (char c in n.Type) Mix(c);
+            }
+            var connections = (ConnectionRecord[])Connections.Clone();
+            Array.Sort(connections, (a, b) =>
+                a.TargetId != b.TargetId ? a.TargetId.CompareTo(b.TargetId) :
+                a.TargetSlot != b.TargetSlot ? a.TargetSlot.CompareTo(b.TargetSlot) :
+                a.SourceId != b.SourceId ? a.SourceId.CompareTo(b.SourceId) : a.SourceSlot.CompareTo(b.SourceSlot));
+            foreach (var c in connections) { Mix(c.SourceId); Mix(c.SourceSlot); Mix(c.TargetId); Mix(c.TargetSlot); }
+            return hash;
+        }
+
+        public void WriteTo(TextWriter writer)
+        {
+            writer.WriteLine(Header);
+            foreach (var n in Nodes) writer.WriteLine($"NODE {n.Id} {n.Type} {n.X} {n.Y} {n.Data}");
+            foreach (var c in Connections) writer.WriteLine($"CONN {c.SourceId} {c.SourceSlot} {c.TargetId} {c.TargetSlot}");
+            foreach (var v in Views) writer.WriteLine($"VIEW {v.Id} {v.Rect.X} {v.Rect.Y} {v.Rect.Width} {v.Rect.Height}");
+        }
+
+        public override string ToString()
+        {
+            using var writer = new StringWriter(new StringBuilder(Nodes.Length * 32 + Connections.Length * 16));
+            WriteTo(writer);
+            return writer.ToString();
+        }
+    }
+}
@@ -0,0 +1,228 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Runs a design without a window, for load tests and automation:
+    //   ToyConEngine --headless design.toy [--ticks N] [--rate HZ] [--inject SOCKET] [--lockstep] [--share]
+    //                [--export OUT.y4m|OUT.rgba|DIR] [--every N] [--no-prune] [--partitions N [--verify]]
+    // --rate 0 (default) ticks as fast as possible; --lockstep waits for the injector's
+    // client before every tick; --share publishes outputs like File > Share Output;
+    // --export records every Nth screen frame (see FrameExporter); --no-prune also runs
+    // nodes that feed no output; --partitions splits the design across N processes on this
+    // host (see PartitionedRunner) and --verify checks the result against a single-process run.
+    public static class HeadlessHost
+    {
+        public static int Run(string[] args)
+        {
+            string design = null;
+            long ticks = 0;
+            double rate = 0;
+            string socket = null;
+            bool lockstep = false, share = false, prune = true;
+            string export = null;
+            int every = 1, partitions = 1;
+            bool verify = false;
+
+            for (int i = 0; i < args.Length; i++)
+            {
+                switch (args[i])
+                {
+                    case "--ticks": ticks = long.Parse(args[++i]); break;
+                    case "--rate": rate = double.Parse(args[++i]); break;
+                    case "--inject": socket = args[++i]; break;
+                    case "--lockstep": lockstep = true; break;
+                    case "--share": share = true; break;
+                    case "--no-prune": prune = false; break;
+                    case "--export": export = args[++i]; break;
+                    case "--every": every = int.Parse(args[++i]); break;
+                    case "--partitions": partitions = int.Parse(args[++i]); break;
+                    case "--verify": verify = true; break;
+                    default: design = args[i]; break;
+                }
+            }
+
+            if (design == null || !File.Exists(design))
+            {
+                Console.Error.WriteLine("usage: --headless design.toy [--ticks N] [--rate HZ] [--inject SOCKET] [--lockstep] [--share] [--export OUT] [--every N] [--no-prune] [--partitions N [--verify]]");
+                return 1;
+            }
+            if (lockstep && socket == null)
+            {
+                Console.Error.WriteLine("--lockstep needs --inject");
+                return 1;
+            }
+
+            if (partitions > 1)
+            {
+                if (socket != null || share || export != null)
+                {
+                    Console.Error.WriteLine("--partitions cannot be combined with --inject, --share or --export");
+                    return 1;
+                }
+                return RunPartitioned(design, partitions, ticks, rate, prune, verify);
+            }
+
+            var engine = new GraphEngine { PruneDeadNodes = prune };
+            DesignLoader.Load(engine, DesignFile.ReadLines(design));
+
+            using var injector = socket != null ? new InputInjector(socket) : null;
+            using var channel = share ? new SharedOutputChannel(SharedOutputChannel.DefaultPath) : null;
+            if (injector != null) engine.Ticking += injector.Apply;
+            if (channel != null) engine.Ticked += channel.Publish;
+            var exporter = export != null ? new FrameExporter(export, every, rate > 0 ? rate : 60) : null;
+            if (exporter != null) engine.Ticked += exporter.OnTick;
+
+            bool stop = false;
+            Console.CancelKeyPress += (s, e) => { e.Cancel = true; stop = true; };
+
+            // Simulated time advances one step per tick so runs are reproducible at any speed
+            var step = TimeSpan.FromSeconds(1.0 / (rate > 0 ? rate : 60));
+            var total = TimeSpan.Zero;
+            var sw = Stopwatch.StartNew();
+
+            while (!stop && (ticks == 0 || engine.TickCount < ticks))
+            {
+                if (lockstep && !injector.WaitForTick(engine.TickCount, 1000)) continue;
+
+                total += step;
+                engine.Tick(new GameTime(total, step));
+
+                if (rate > 0)
+                {
+                    var due = TimeSpan.FromTicks(step.Ticks * engine.TickCount);
+                    var wait = due - sw.Elapsed;
+                    if (wait > TimeSpan.FromMilliseconds(1)) Thread.Sleep(wait);
+                }
+            }
+
+            double seconds = sw.Elapsed.TotalSeconds;
+            if (exporter != null)
+            {
+                exporter.Dispose();
+                Console.WriteLine($"frames: {exporter.Written} written, {exporter.Dropped} dropped{(exporter.LastError != null ? ", " + exporter.LastError : "")}");
+            }
+            Console.WriteLine($"{engine.TickCount} ticks in {seconds:F3}s ({engine.TickCount / Math.Max(seconds, 1e-9):F0} TPS), {engine.Nodes.Count} nodes");
+            if (injector != null)
+                Console.WriteLine($"input: {injector.Received} received, {injector.Applied} applied, {injector.Late} late, {injector.Unknown} unknown");
+            return 0;
+        }
+
+        // This process runs partition 0 and starts one worker process per other partition
+        private static int RunPartitioned(string design, int count, long ticks, double rate, bool prune, bool verify)
+        {
+            var engine = new GraphEngine { PruneDeadNodes = prune };
+            DesignLoader.Load(engine, DesignFile.ReadLines(design));
+
+            string path = Path.Combine(Directory.Exists("/dev/shm") ? "/dev/shm" : Path.GetTempPath(), $"toycon_part_{Environment.ProcessId}");
+            var step = TimeSpan.FromSeconds(1.0 / (rate > 0 ? rate : 60));
+            var workers = new List<Process>();
+            try
+            {
+                using var runner = new PartitionedRunner(engine, path, 0, count);
+                for (int p = 1; p < count; p++)
+                    workers.Add(StartWorker(design, path, p, count, ticks, rate, prune));
+
+                bool stop = false;
+                Console.CancelKeyPress += (s, e) => { e.Cancel = true; stop = true; };
+
+                var sw = Stopwatch.StartNew();
+                runner.Run(ticks, step, () =>
+                {
+                    if (rate > 0)
+                    {
+                        var wait = TimeSpan.FromTicks(step.Ticks * engine.TickCount) - sw.Elapsed;
+                        if (wait > TimeSpan.FromMilliseconds(1)) Thread.Sleep(wait);
+                    }
+                    return stop;
+                });
+                double seconds = sw.Elapsed.TotalSeconds;
+                long checksum = runner.Finish();
+                foreach (var w in workers) w.WaitForExit();
+
+                Console.WriteLine($"{engine.TickCount} ticks in {seconds:F3}s ({engine.TickCount / Math.Max(seconds, 1e-9):F0} TPS), {engine.Nodes.Count} nodes");
+                Console.WriteLine($"partitions: {count}, {runner.OwnedCount} nodes here, {runner.SlotCount} cut ports, {runner.ExchangeLevels} exchanges per tick");
+
+                if (verify)
+                {
+                    if (engine.Nodes.Any(n => n is RandomNode))
+                    {
+                        Console.WriteLine("verify: skipped, the design uses RandomNode");
+                        return 0;
+                    }
+                    var single = new GraphEngine { PruneDeadNodes = prune };
+                    DesignLoader.Load(single, DesignFile.ReadLines(design));
+                    var total = TimeSpan.Zero;
+                    while (single.TickCount < engine.TickCount)
+                    {
+                        total += step;
+                        single.Tick(new GameTime(total, step));
+                    }
+                    long expected = PartitionedRunner.Checksum(single, n => true);
+                    Console.WriteLine(expected == checksum ? $"verify: ok ({checksum:x16})" : $"verify: MISMATCH ({checksum:x16}, single process {expected:x16})");
+                    if (expected != checksum) return 2;
+                }
+                return 0;
+            }
+            catch (TimeoutException e)
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+            finally
+            {
+                foreach (var w in workers)
+                {
+                    if (!w.HasExited) w.Kill();
+                    w.Dispose();
+                }
+                File.Delete(path);
+            }
+        }
+
+        private static Process StartWorker(string design, string path, int index, int count, long ticks, double rate, bool prune)
+        {
+            var info = new ProcessStartInfo { UseShellExecute = false };
+            // Under `dotnet run` the process is the dotnet host, so the assembly has to be named
+            string host = Environment.ProcessPath;
+            if (Path.GetFileNameWithoutExtension(host) == "dotnet") info.ArgumentList.Add(Assembly.GetEntryAssembly().Location);
+            info.FileName = host;
+            foreach (var arg in new[] { "--partition-worker", design, path, index.ToString(), count.ToString(), ticks.ToString(), rate.ToString(), prune ? "1" : "0" })
+                info.ArgumentList.Add(arg);
+            return Process.Start(info);
+        }
+
+        // Entry point of the worker processes started by RunPartitioned
+        public static int RunPartitionWorker(string[] args)
+        {
+            string design = args[0], path = args[1];
+            int index = int.Parse(args[2]), count = int.Parse(args[3]);
+            long ticks = long.Parse(args[4]);
+            double rate = double.Parse(args[5]);
+
+            var engine = new GraphEngine { PruneDeadNodes = args[6] == "1" };
+            DesignLoader.Load(engine, DesignFile.ReadLines(design));
+
+            // Ctrl+C reaches the whole process group; partition 0 decides when everyone stops
+            Console.CancelKeyPress += (s, e) => e.Cancel = true;
+            try
+            {
+                using var runner = new PartitionedRunner(engine, path, index, count);
+                runner.Run(ticks, TimeSpan.FromSeconds(1.0 / (rate > 0 ? rate : 60)));
+                runner.Finish();
+                return 0;
+            }
+            catch (TimeoutException e)
+            {
+                Console.Error.WriteLine($"partition {index}: {e.Message}");
+                return 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Net.Sockets;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Drives input nodes from another process over a Unix domain socket. Clients write
+    // batches of fixed 20-byte little-endian records:
+    //   i64 tick, i32 node id, i32 port, f32 value
+    // Each record is applied just before tick number `tick` runs (tick < 0: at the next
+    // tick). Node ids are the design file's; a record for node 0 only marks that the client
+    // has sent everything up to its tick (see WaitForTick). Sockets are read on background
+    // threads; the engine side only drains a queue at the tick boundary.
+    public sealed class InputInjector : IDisposable
+    {
+        public const int RecordSize = 20;
+        public static string DefaultPath => Path.Combine(Path.GetTempPath(), "toycon_input.sock");
+
+        public readonly struct InputEvent
+        {
+            public readonly long Tick;
+            public readonly int NodeId;
+            public readonly int Port;
+            public readonly float Value;
+
+            public InputEvent(long tick, int nodeId, int port, float value)
+            {
+                Tick = tick; NodeId = nodeId; Port = port; Value = value;
+            }
+        }
+
+        public string SocketPath { get; }
+        public long Received => Interlocked.Read(ref _received);
+        public long Applied { get; private set; }
+        // Arrived after their tick had already run; applied at the next one instead
+        public long Late { get; private set; }
+        // Named a node that does not exist or cannot be injected
+        public long Unknown { get; private set; }
+
+        private readonly Socket _listener;
+        private readonly ConcurrentQueue<InputEvent> _incoming = new ConcurrentQueue<InputEvent>();
+        private readonly PriorityQueue<InputEvent, long> _pending = new PriorityQueue<InputEvent, long>();
+        private readonly object _watermarkLock = new object();
+        private long _watermark = -1;
+        private long _received;
+        private volatile bool _disposed;
+
+        public InputInjector(string socketPath)
+        {
+            SocketPath = socketPath;
+            if (File.Exists(socketPath)) File.Delete(socketPath);
+
+            _listener = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+            _listener.Bind(new UnixDomainSocketEndPoint(socketPath));
+            _listener.Listen(4);
+            new Thread(AcceptLoop) { IsBackground = true, Name = "InputInjector" }.Start();
+        }
+
+        // Hook for GraphEngine.Ticking
+        public void Apply(GraphEngine engine)
+        {
+            while (_incoming.TryDequeue(out var e)) _pending.Enqueue(e, e.Tick < 0 ? long.MinValue : e.Tick);
+
+            long now = engine.TickCount;
+            while (_pending.TryPeek(out var e, out long tick) && tick <= now)
+            {
+                _pending.Dequeue();
+                if (e.NodeId == 0) continue;
+                if (e.Tick >= 0 && e.Tick < now) Late++;
+
+                if (engine.FindNode(e.NodeId) is IInjectableInput input) { input.Inject(e.Port, e.Value); Applied++; }
+                else Unknown++;
+            }
+        }
+
+        // Lockstep driving: blocks until a client has sent records up to the given tick,
+        // or the timeout runs out. False on timeout.
+        public bool WaitForTick(long tick, int timeoutMs = Timeout.Infinite)
+        {
+            lock (_watermarkLock)
+            {
+                while (_watermark < tick)
+                {
+                    if (_disposed || !Monitor.Wait(_watermarkLock, timeoutMs)) return false;
+                }
+                return true;
+            }
+        }
+
+        private void AcceptLoop()
+        {
+            try
+            {
+                while (!_disposed)
+                {
+                    var client = _listener.Accept();
+                    new Thread(() => ReadLoop(client)) { IsBackground = true, Name = "InputInjector client" }.Start();
+                }
+            }
+            catch (SocketException) { }
+            catch (ObjectDisposedException) { }
+        }
+
+        private void ReadLoop(Socket client)
+        {
+            var buffer = new byte[RecordSize * 4096];
+            int filled = 0;
+            try
+            {
+                using (client)
+                {
+                    int n;
+                    while ((n = client.Receive(buffer, filled, buffer.Length - filled, SocketFlags.None)) > 0)
+                    {
+                        filled += n;
+                        int records = filled / RecordSize;
+                        long highest = -1;
+                        for (int r = 0; r < records; r++)
+                        {
+                            var span = buffer.AsSpan(r * RecordSize, RecordSize);
+                            var e = new InputEvent(
+                                BitConverter.ToInt64(span),
+                                BitConverter.ToInt32(span.Slice(8)),
+                                BitConverter.ToInt32(span.Slice(12)),
+                                BitConverter.ToSingle(span.Slice(16)));
+                            _incoming.Enqueue(e);
+                            // Ordinary records may be sent ahead of ticks whose input is still to come
+                            if (e.NodeId == 0 && e.Tick > highest) highest = e.Tick;
+                        }
+                        Interlocked.Add(ref _received, records);
+
+                        // Keep a partial record for the next read
+                        int used = records * RecordSize;
+                        Buffer.BlockCopy(buffer, used, buffer, 0, filled - used);
+                        filled -= used;
+
+                        if (highest > Volatile.Read(ref _watermark))
+                        {
+                            lock (_watermarkLock)
+                            {
+                                if (highest > _watermark) _watermark = highest;
+                                Monitor.PulseAll(_watermarkLock);
+                            }
+                        }
+                    }
+                }
+            }
+            catch (SocketException) { }
+            catch (ObjectDisposedException) { }
+        }
+
+        public void Dispose()
+        {
+            _disposed = true;
+            _listener.Dispose();
+            lock (_watermarkLock) Monitor.PulseAll(_watermarkLock);
+            try { File.Delete(SocketPath); } catch (IOException) { }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+using Microsoft.Xna.Framework.Input;
+
+namespace ToyConEngine
+{
+    // Keyboard and mouse as seen at the start of the frame. Input nodes read this instead
+    // of polling the OS once per node per tick; without a window (headless) nothing is pressed.
+    // Background tabs read it from worker threads, so both states are swapped in as one
+    // immutable object and a reader never sees half of a capture.
+    public static class InputSnapshot
+    {
+        private sealed class State
+        {
+            public readonly KeyboardState Keyboard;
+            public readonly MouseState Mouse;
+            public State(KeyboardState keyboard, MouseState mouse) { Keyboard = keyboard; Mouse = mouse; }
+        }
+
+        private static volatile State _state = new State(default, default);
+
+        public static KeyboardState Keyboard => _state.Keyboard;
+        public static MouseState Mouse => _state.Mouse;
+
+        public static void Capture(KeyboardState keyboard, MouseState mouse) => _state = new State(keyboard, mouse);
+    }
+}
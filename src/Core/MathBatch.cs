@@ -0,0 +1,137 @@
+using System;
+using System.Numerics;
+
+namespace ToyConEngine
+{
+    // A group of MathNodes with the same Operation inside one topological level.
+    // Inputs are gathered into contiguous lanes, evaluated with one Vector<float> kernel
+    // and the results are scattered back to the output ports.
+    public sealed class MathBatch
+    {
+        public MathNode.Operation Op { get; }
+        public MathNode[] Nodes { get; }
+
+        private readonly InputPort[] _inA, _inB, _inC;
+        private readonly float[] _a, _b, _c, _r;
+
+        public MathBatch(MathNode.Operation op, MathNode[] nodes)
+        {
+            Op = op;
+            Nodes = nodes;
+
+            int count = nodes.Length;
+            int width = Vector<float>.Count;
+            int padded = (count + width - 1) / width * width;
+
+            _inA = new InputPort[count];
+            _inB = new InputPort[count];
+            _inC = new InputPort[count];
+            for (int i = 0; i < count; i++)
+            {
+                var inputs = nodes[i].Inputs;
+                _inA[i] = inputs.Count > 0 ? inputs[0] : null;
+                _inB[i] = inputs.Count > 1 ? inputs[1] : null;
+                _inC[i] = inputs.Count > 2 ? inputs[2] : null;
+            }
+
+            _a = new float[padded];
+            _b = new float[padded];
+            _c = new float[padded];
+            _r = new float[padded];
+        }
+
+        public void Run()
+        {
+            int arity = MathNode.ArityOf(Op);
+            Gather(_inA, _a);
+            if (arity > 1) Gather(_inB, _b);
+            if (arity > 2) Gather(_inC, _c);
+
+            Execute(Op, _a, _b, _c, _r);
+
+            for (int i = 0; i < Nodes.Length; i++)
+                Nodes[i].Outputs[0].SetValue(_r[i]);
+        }
+
+        private static void Gather(InputPort[] ports, float[] lanes)
+        {
+            for (int i = 0; i < ports.Length; i++)
+                lanes[i] = ports[i] != null ? ports[i].GetValue() : 0f;
+        }
+
+        // Lane arrays must be padded to a multiple of Vector<float>.Count.
+        public static void Execute(MathNode.Operation op, float[] a, float[] b, float[] c, float[] r)
+        {
+            int width = Vector<float>.Count;
+            var zero = Vector<float>.Zero;
+            var one = Vector<float>.One;
+
+            for (int i = 0; i < r.Length; i += width)
+            {
+                var va = new Vector<float>(a, i);
+                Vector<float> vr;
+                switch (op)
+                {
+                    case MathNode.Operation.Add: vr = va + new Vector<float>(b, i); break;
+                    case MathNode.Operation.Subtract: vr = va - new Vector<float>(b, i); break;
+                    case MathNode.Operation.Multiply: vr = va * new Vector<float>(b, i); break;
+                    case MathNode.Operation.Divide:
+                        {
+                            // b != 0 ? a / b : 0, without a branch per lane
+                            var vb = new Vector<float>(b, i);
+                            var isZero = Vector.Equals(vb, zero);
+                            vr = Vector.ConditionalSelect(isZero, zero, va / Vector.ConditionalSelect(isZero, one, vb));
+                            break;
+                        }
+                    case MathNode.Operation.Abs: vr = Vector.Abs(va); break;
+                    case MathNode.Operation.Select:
+                        vr = Vector.ConditionalSelect(Vector.GreaterThan(va, zero), new Vector<float>(b, i), new Vector<float>(c, i));
+                        break;
+                    case MathNode.Operation.Min: vr = Min(va, new Vector<float>(b, i)); break;
+                    case MathNode.Operation.Max: vr = Max(va, new Vector<float>(b, i)); break;
+                    case MathNode.Operation.Modulo:
+                        {
+                            var vb = new Vector<float>(b, i);
+                            var isZero = Vector.Equals(vb, zero);
+                            var safeB = Vector.ConditionalSelect(isZero, one, vb);
+                            vr = Vector.ConditionalSelect(isZero, zero, va - safeB * Vector.Floor(va / safeB));
+                            break;
+                        }
+                    case MathNode.Operation.Floor: vr = Vector.Floor(va); break;
+                    case MathNode.Operation.Clamp: vr = Min(Max(va, new Vector<float>(b, i)), new Vector<float>(c, i)); break;
+                    case MathNode.Operation.Lerp:
+                        {
+                            var vb = new Vector<float>(b, i);
+                            vr = va + (vb - va) * new Vector<float>(c, i);
+                            break;
+                        }
+                    case MathNode.Operation.ApproxEqual:
+                        vr = Vector.ConditionalSelect(Vector.LessThanOrEqual(Vector.Abs(va - new Vector<float>(b, i)), new Vector<float>(c, i)), one, zero);
+                        break;
+                    case MathNode.Operation.Sin:
+                    case MathNode.Operation.Cos:
+                        // No vector transcendental in System.Numerics, the lanes are still contiguous
+                        for (int j = i; j < i + width; j++) r[j] = op == MathNode.Operation.Sin ? MathF.Sin(a[j]) : MathF.Cos(a[j]);
+                        continue;
+                    default: vr = zero; break;
+                }
+                vr.CopyTo(r, i);
+            }
+        }
+
+        // Math.Min/Max per lane. Vector.Min/Max follow the hardware instead (minps returns its
+        // second operand when either is NaN, and either zero for -0 vs +0), which would make a
+        // node's result depend on whether it landed in a batch.
+        internal static Vector<float> Min(Vector<float> a, Vector<float> b)
+        {
+            var r = Vector.ConditionalSelect(Vector.Equals(a, b), a | b, Vector.Min(a, b));
+            return Vector.ConditionalSelect(Vector.Equals(a, a), Vector.ConditionalSelect(Vector.Equals(b, b), r, b), a);
+        }
+
+        internal static Vector<float> Max(Vector<float> a, Vector<float> b)
+        {
+            var r = Vector.ConditionalSelect(Vector.Equals(a, b), a & b, Vector.Max(a, b));
+            return Vector.ConditionalSelect(Vector.Equals(a, a), Vector.ConditionalSelect(Vector.Equals(b, b), r, b), a);
+        }
+    }
+}
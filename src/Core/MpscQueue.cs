@@ -0,0 +1,46 @@
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Unbounded multi-producer/single-consumer queue (Vyukov's linked list). A producer
+    // swaps itself in as the head with one interlocked exchange and then links the old head
+    // to it; the consumer only follows Next pointers, so neither side ever waits on a lock.
+    // An item whose producer has exchanged but not linked yet is simply seen on a later
+    // TryDequeue.
+    public sealed class MpscQueue<T>
+    {
+        private sealed class Cell
+        {
+            public T Value;
+            public Cell Next;
+        }
+
+        private Cell _head; // producers
+        private Cell _tail; // consumer; always a cell whose value was already taken
+
+        public MpscQueue()
+        {
+            _head = _tail = new Cell();
+        }
+
+        public bool IsEmpty => Volatile.Read(ref _tail.Next) == null;
+
+        public void Enqueue(T item)
+        {
+            var cell = new Cell { Value = item };
+            var previous = Interlocked.Exchange(ref _head, cell);
+            Volatile.Write(ref previous.Next, cell);
+        }
+
+        // Consumer thread only
+        public bool TryDequeue(out T item)
+        {
+            var next = Volatile.Read(ref _tail.Next);
+            if (next == null) { item = default; return false; }
+            item = next.Value;
+            next.Value = default;
+            _tail = next;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,20 @@
+namespace ToyConEngine
+{
+    // A node's saved settings as raw values (see DesignLoader.CaptureNodeState). Copying
+    // them is cheap enough for a tick boundary on the UI thread; the design file text is
+    // built from them later (DesignLoader.FormatNodeState), on any thread.
+    public readonly struct NodeState
+    {
+        public readonly float Value;      // constant, counter
+        public readonly int Kind;         // operation, gate or aggregate type, key
+        public readonly int Count;        // aggregate inputs, toy port index, shared bank
+        public readonly bool Flag;        // toggle button, read-only memory
+        public readonly string Text;      // sound, script, file path
+        public readonly float[] Floats;   // memory contents, a private copy
+
+        public NodeState(float value = 0, int kind = 0, int count = 0, bool flag = false, string text = null, float[] floats = null)
+        {
+            Value = value; Kind = kind; Count = count; Flag = flag; Text = text; Floats = floats;
+        }
+    }
+}
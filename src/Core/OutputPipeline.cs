@@ -0,0 +1,162 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Takes output side effects off the tick. After every tick (Publish, a GraphEngine.Ticked
+    // hook) the sinks are reduced to small per-tick records and handed to stages over SPSC
+    // queues, and the engine moves on to the next tick:
+    //   audio       - beeps that fired this tick, played on the audio stage thread in tick order
+    //   metrics     - tick number and time, turned into TicksPerSecond on the metrics thread
+    //   framebuffer - a copy of every screen that changed (ScreenNode.Version) since the last
+    //                 frame, taken when the draw side has used that frame; textures can only be
+    //                 uploaded on the draw thread, so Draw is this stage's consumer
+    //                 (TryTakeFrame) and the picture lags by at most one frame
+    // Publish must always be called from the same thread.
+    public sealed class OutputPipeline : IDisposable
+    {
+        public const int AudioCapacity = 256;
+        public const int MetricsCapacity = 4096;
+
+        public readonly struct Beep
+        {
+            public readonly long Tick;
+            public readonly string SoundName;
+            public readonly float Volume;
+            public readonly float Pitch;
+            public Beep(long tick, string soundName, float volume, float pitch) { Tick = tick; SoundName = soundName; Volume = volume; Pitch = pitch; }
+        }
+
+        private readonly struct TickRecord
+        {
+            public readonly long Tick;
+            public readonly long Timestamp;
+            public TickRecord(long tick, long timestamp) { Tick = tick; Timestamp = timestamp; }
+        }
+
+        public sealed class Frame
+        {
+            public long Tick;
+            public readonly List<(ScreenNode Screen, Color[] Pixels)> Screens = new List<(ScreenNode, Color[])>();
+        }
+
+        public double TicksPerSecond => Volatile.Read(ref _ticksPerSecond);
+        public long BeepsPlayed => _audio.Processed;
+        // Tick thread count, read by the host to tell when audio is being produced
+        public long BeepsPosted { get; private set; }
+        public long AudioStalls => _audio.Stalls;
+
+        private readonly OutputStage<Beep> _audio;
+        private readonly OutputStage<TickRecord> _metrics;
+        private readonly SpscQueue<Frame> _frames = new SpscQueue<Frame>(2);
+        private readonly ConcurrentBag<Frame> _framePool = new ConcurrentBag<Frame>();
+        private int _frameWanted = 1;
+
+        // Sinks are looked up again only when the engine recompiles its plan
+        private ExecutionPlan _plan;
+        private readonly List<BeepOutputNode> _beeps = new List<BeepOutputNode>();
+        private readonly List<ScreenNode> _screens = new List<ScreenNode>();
+        // ScreenNode.Version of each screen when it was last copied into a frame
+        private readonly List<int> _sentVersions = new List<int>();
+
+        // Metrics stage state, only touched by its thread
+        private long _windowTick, _windowStart;
+        private double _ticksPerSecond;
+
+        public OutputPipeline(Action<Beep> play)
+        {
+            _audio = new OutputStage<Beep>("ToyCon audio", AudioCapacity, play);
+            _metrics = new OutputStage<TickRecord>("ToyCon metrics", MetricsCapacity, Measure);
+        }
+
+        // Hook for GraphEngine.Ticked
+        public void Publish(GraphEngine engine)
+        {
+            if (_plan != engine.Plan) FindSinks(engine);
+            long tick = engine.TickCount;
+
+            foreach (var beep in _beeps)
+                if (beep.ShouldPlay) { _audio.Post(new Beep(tick, beep.SoundName, beep.Volume, beep.Pitch)); BeepsPosted++; }
+
+            _metrics.Post(new TickRecord(tick, Stopwatch.GetTimestamp()));
+
+            if (_screens.Count > 0 && Volatile.Read(ref _frameWanted) == 1)
+            {
+                Frame frame = null;
+                int count = 0;
+                for (int i = 0; i < _screens.Count; i++)
+                {
+                    var screen = _screens[i];
+                    if (screen.Version == _sentVersions[i]) continue;
+                    if (frame == null && !_framePool.TryTake(out frame)) frame = new Frame();
+                    // Pooled frames keep their pixel arrays; screens are all the same size
+                    var pixels = count < frame.Screens.Count ? frame.Screens[count].Pixels : new Color[screen.Buffer.Length];
+                    Array.Copy(screen.Buffer, pixels, pixels.Length);
+                    if (count < frame.Screens.Count) frame.Screens[count] = (screen, pixels);
+                    else frame.Screens.Add((screen, pixels));
+                    _sentVersions[i] = screen.Version;
+                    count++;
+                }
+                if (frame != null)
+                {
+                    if (frame.Screens.Count > count) frame.Screens.RemoveRange(count, frame.Screens.Count - count);
+                    frame.Tick = tick;
+                    Volatile.Write(ref _frameWanted, 0);
+                    if (!_frames.TryEnqueue(frame)) { _framePool.Add(frame); Resend(); }
+                }
+            }
+        }
+
+        // Copies every screen into the next frame, changed or not; for when the draw side
+        // starts showing screens somewhere new
+        public void Resend() => _plan = null;
+
+        // True when TryTakeFrame has a frame waiting
+        public bool HasFrame => _frames.Count > 0;
+
+        // Draw thread: the newest frame since the last call, if any. Hand it back with ReturnFrame.
+        public bool TryTakeFrame(out Frame frame)
+        {
+            if (!_frames.TryDequeue(out frame)) return false;
+            Volatile.Write(ref _frameWanted, 1);
+            return true;
+        }
+
+        public void ReturnFrame(Frame frame) => _framePool.Add(frame);
+
+        private void FindSinks(GraphEngine engine)
+        {
+            _plan = engine.Plan;
+            _beeps.Clear();
+            _screens.Clear();
+            foreach (var node in engine.Nodes)
+            {
+                if (node is BeepOutputNode beep) _beeps.Add(beep);
+                else if (node is ScreenNode screen) _screens.Add(screen);
+                else if (node is ToyNode toy && toy.GetScreenNode() is ScreenNode inner) _screens.Add(inner);
+            }
+            _sentVersions.Clear();
+            foreach (var screen in _screens) _sentVersions.Add(screen.Version - 1);
+        }
+
+        private void Measure(TickRecord record)
+        {
+            if (_windowStart == 0 || record.Tick < _windowTick) { _windowStart = record.Timestamp; _windowTick = record.Tick; return; }
+            long elapsed = record.Timestamp - _windowStart;
+            if (elapsed < Stopwatch.Frequency / 2) return;
+            Volatile.Write(ref _ticksPerSecond, (record.Tick - _windowTick) * (double)Stopwatch.Frequency / elapsed);
+            _windowStart = record.Timestamp;
+            _windowTick = record.Tick;
+        }
+
+        public void Dispose()
+        {
+            _audio.Dispose();
+            _metrics.Dispose();
+        }
+    }
+}
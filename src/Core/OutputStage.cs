@@ -0,0 +1,88 @@
+using System;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // One consumer thread draining an SpscQueue in order. Post never drops: when the
+    // stage falls a whole queue behind, the tick waits for it (counted in Stalls), so
+    // output is delayed but never lost or reordered. The thread sleeps while the queue
+    // is empty and is only woken by a post that finds it asleep.
+    public sealed class OutputStage<T> : IDisposable
+    {
+        private const int IdleSpins = 64;
+
+        public string Name { get; }
+        public long Processed => Interlocked.Read(ref _processed);
+        public long Stalls { get; private set; }
+
+        private readonly SpscQueue<T> _queue;
+        private readonly Action<T> _handle;
+        private readonly Thread _thread;
+        private readonly ManualResetEventSlim _signal = new ManualResetEventSlim(false);
+        private volatile bool _stopping;
+        private int _sleeping;
+        private long _processed;
+
+        public OutputStage(string name, int capacity, Action<T> handle)
+        {
+            Name = name;
+            _queue = new SpscQueue<T>(capacity);
+            _handle = handle;
+            _thread = new Thread(Loop) { IsBackground = true, Name = name };
+            _thread.Start();
+        }
+
+        // Producer only
+        public void Post(T item)
+        {
+            if (!_queue.TryEnqueue(item))
+            {
+                Stalls++;
+                var spin = new SpinWait();
+                do { _signal.Set(); spin.SpinOnce(); } while (!_queue.TryEnqueue(item));
+            }
+            // Pairs with the fence in Loop: either we see it asleep or it sees the item
+            Interlocked.MemoryBarrier();
+            if (Volatile.Read(ref _sleeping) == 1) _signal.Set();
+        }
+
+        private void Loop()
+        {
+            int idle = 0;
+            while (true)
+            {
+                if (_queue.TryDequeue(out var item))
+                {
+                    Run(item);
+                    idle = 0;
+                    continue;
+                }
+                if (_stopping) break;
+                if (++idle < IdleSpins) { Thread.SpinWait(20); continue; }
+
+                _signal.Reset();
+                Volatile.Write(ref _sleeping, 1);
+                Interlocked.MemoryBarrier();
+                if (_queue.Count == 0 && !_stopping) _signal.Wait();
+                Volatile.Write(ref _sleeping, 0);
+                idle = 0;
+            }
+        }
+
+        private void Run(T item)
+        {
+            // A failing sink must not take the stage down with it
+            try { _handle(item); } catch { }
+            Interlocked.Increment(ref _processed);
+        }
+
+        // Drains what was already posted, then stops the thread
+        public void Dispose()
+        {
+            _stopping = true;
+            _signal.Set();
+            _thread.Join();
+            _signal.Dispose();
+        }
+    }
+}
@@ -0,0 +1,221 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Text;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Runs one partition of a design (see GraphPartitioner) in this process. Every process
+    // loads the same design and computes the same partition, then evaluates only its own
+    // nodes. After each plan level that feeds another partition, the values crossing the cut
+    // are written to a shared memory-mapped file and all processes meet at a barrier; remote
+    // nodes are never evaluated locally, their output ports just hold the imported values.
+    //
+    // Layout, little-endian:
+    //   header: "TOYPART1", i32 partition_count, i32 slot_count; at StopOffset i64 stop word,
+    //     tick * 2 + stop flag (written by partition 0 only)
+    //   at ArriveOffset + p * 64: i64 barrier generation of partition p, i64 checksum of p
+    //   at ArriveOffset + partition_count * 64: f32 slots[slot_count], one per exported port
+    //
+    // Each word has a single writer, so the barrier needs no atomic read-modify-write.
+    public sealed class PartitionedRunner : IDisposable
+    {
+        public const int StopOffset = 64;
+        public const int ArriveOffset = 128;
+        public const int LineSize = 64;
+        public static readonly byte[] Magic = Encoding.ASCII.GetBytes("TOYPART1");
+        public static readonly TimeSpan StartTimeout = TimeSpan.FromSeconds(60);
+        public static readonly TimeSpan TickTimeout = TimeSpan.FromSeconds(10);
+
+        public int Index { get; }
+        public int Count { get; }
+        public int SlotCount { get; }
+        public int OwnedCount { get; }
+        public int ExchangeLevels { get; }
+        public long Barriers { get; private set; }
+
+        private readonly GraphEngine _engine;
+        private readonly Dictionary<Node, int> _owner;
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly long _slotsOffset;
+        private readonly bool _spinOnly;
+        private long _generation;
+
+        // Per plan level: ports this process writes, ports it reads, and whether anyone exchanges there
+        private readonly List<(OutputPort Port, int Slot)>[] _exports;
+        private readonly List<(OutputPort Port, int Slot)>[] _imports;
+        private readonly bool[] _exchange;
+        private readonly Action<int> _afterLevel;
+
+        // Partition 0 creates the file, the others open it after being started by it
+        public PartitionedRunner(GraphEngine engine, string path, int index, int count)
+        {
+            _engine = engine;
+            Index = index;
+            Count = count;
+            _spinOnly = count <= Environment.ProcessorCount;
+
+            // Partition the nodes the plan would schedule, by their plan levels
+            engine.Owned = n => true;
+            var levelOf = engine.Plan.LevelOf;
+            var scheduled = new List<Node>();
+            foreach (var n in engine.Nodes) if (levelOf.ContainsKey(n)) scheduled.Add(n);
+            _owner = GraphPartitioner.Partition(scheduled, count, engine.Plan.NodeLevels);
+            engine.Owned = n => _owner.TryGetValue(n, out int p) && p == index;
+            var plan = engine.Plan;
+
+            foreach (var n in scheduled) if (_owner[n] == index) OwnedCount++;
+
+            int levels = plan.Levels.Length;
+            _exports = new List<(OutputPort, int)>[levels];
+            _imports = new List<(OutputPort, int)>[levels];
+            _exchange = new bool[levels];
+            for (int l = 0; l < levels; l++) { _exports[l] = new List<(OutputPort, int)>(); _imports[l] = new List<(OutputPort, int)>(); }
+
+            // Partitions reading each source port, collected in node-list order so slots match everywhere
+            var readers = new Dictionary<OutputPort, List<int>>();
+            foreach (var n in scheduled)
+            {
+                foreach (var input in n.Inputs)
+                {
+                    foreach (var source in input.ConnectedSources)
+                    {
+                        if (!_owner.TryGetValue(source.ParentNode, out int from) || from == _owner[n]) continue;
+                        if (!readers.TryGetValue(source, out var list)) readers[source] = list = new List<int>();
+                        if (!list.Contains(_owner[n])) list.Add(_owner[n]);
+                    }
+                }
+            }
+
+            int slot = 0;
+            foreach (var n in scheduled)
+            {
+                foreach (var port in n.Outputs)
+                {
+                    if (!readers.TryGetValue(port, out var list)) continue;
+                    int level = plan.LevelOf[n];
+                    _exchange[level] = true;
+                    if (_owner[n] == index) _exports[level].Add((port, slot));
+                    if (list.Contains(index)) _imports[level].Add((port, slot));
+                    slot++;
+                }
+            }
+            SlotCount = slot;
+            foreach (bool e in _exchange) if (e) ExchangeLevels++;
+            _afterLevel = AfterLevel;
+
+            _slotsOffset = ArriveOffset + (long)count * LineSize;
+            long capacity = _slotsOffset + Math.Max(1, SlotCount) * sizeof(float);
+            if (index == 0)
+            {
+                _file = MemoryMappedFile.CreateFromFile(path, FileMode.Create, null, capacity, MemoryMappedFileAccess.ReadWrite);
+                _view = _file.CreateViewAccessor(0, capacity);
+                _view.WriteArray(0, Magic, 0, Magic.Length);
+                _view.Write(8, count);
+                _view.Write(12, SlotCount);
+            }
+            else
+            {
+                _file = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.ReadWrite);
+                _view = _file.CreateViewAccessor(0, capacity);
+                var magic = new byte[Magic.Length];
+                _view.ReadArray(0, magic, 0, magic.Length);
+                if (!magic.AsSpan().SequenceEqual(Magic) || _view.ReadInt32(8) != count || _view.ReadInt32(12) != SlotCount)
+                    throw new InvalidDataException("partition file does not match this design");
+            }
+        }
+
+        // Runs ticks until `ticks` is reached (0 = until partition 0 is told to stop).
+        // Only partition 0's `stop` is consulted; its decision reaches the others with the tick barrier.
+        public void Run(long ticks, TimeSpan step, Func<bool> stop = null)
+        {
+            Barrier(StartTimeout);
+            var total = TimeSpan.Zero;
+            while (ticks == 0 || _engine.TickCount < ticks)
+            {
+                total += step;
+                _engine.Tick(new GameTime(total, step), _afterLevel);
+
+                // Also keeps a fast partition from overwriting slots a slow one has not read yet
+                long tick = _engine.TickCount;
+                if (Index == 0) _view.Write(StopOffset, tick * 2 + (stop != null && stop() ? 1 : 0));
+                Barrier(TickTimeout);
+                // With no exchange levels partition 0 may already have written the next tick's
+                // word; it only gets that far when this tick's flag was clear, so a word for a
+                // later tick means carry on
+                if (_view.ReadInt64(StopOffset) == tick * 2 + 1) break;
+            }
+        }
+
+        private void AfterLevel(int level)
+        {
+            if (!_exchange[level]) return;
+            foreach (var (port, slot) in _exports[level]) _view.Write(_slotsOffset + slot * sizeof(float), port.Value);
+            Barrier(TickTimeout);
+            foreach (var (port, slot) in _imports[level]) port.SetValue(_view.ReadSingle(_slotsOffset + slot * sizeof(float)));
+        }
+
+        private void Barrier(TimeSpan timeout)
+        {
+            long generation = ++_generation;
+            Thread.MemoryBarrier();
+            _view.Write(ArriveOffset + (long)Index * LineSize, generation);
+            Barriers++;
+
+            var spin = new SpinWait();
+            long deadline = 0;
+            for (int p = 0; p < Count; p++)
+            {
+                while (_view.ReadInt64(ArriveOffset + (long)p * LineSize) < generation)
+                {
+                    // More processes than cores: let the others run instead of burning the slice
+                    spin.SpinOnce(_spinOnly ? -1 : 20);
+                    if (!spin.NextSpinWillYield) continue;
+                    if (deadline == 0) deadline = Stopwatch.GetTimestamp() + (long)(timeout.TotalSeconds * Stopwatch.Frequency);
+                    else if (Stopwatch.GetTimestamp() > deadline) throw new TimeoutException($"partition {p} did not reach the barrier");
+                }
+            }
+            Thread.MemoryBarrier();
+        }
+
+        // Publishes this partition's checksum and, on partition 0, returns the combined one
+        public long Finish()
+        {
+            long sum = Checksum(_engine, n => _owner.TryGetValue(n, out int p) ? p == Index : Index == 0);
+            _view.Write(ArriveOffset + (long)Index * LineSize + 8, sum);
+            Barrier(TickTimeout);
+            if (Index != 0) return sum;
+            for (int p = 1; p < Count; p++) sum ^= _view.ReadInt64(ArriveOffset + (long)p * LineSize + 8);
+            return sum;
+        }
+
+        // Order-independent hash of node outputs, so per-partition sums XOR to the single-process one
+        public static long Checksum(GraphEngine engine, Predicate<Node> include)
+        {
+            long sum = 0;
+            foreach (var node in engine.Nodes)
+            {
+                if (!include(node)) continue;
+                for (int i = 0; i < node.Outputs.Count; i++)
+                {
+                    ulong h = ((ulong)(uint)node.Id << 32 | (uint)i) * 0x9E3779B97F4A7C15UL;
+                    h ^= (uint)BitConverter.SingleToInt32Bits(node.Outputs[i].Value);
+                    h *= 0xBF58476D1CE4E5B9UL;
+                    sum ^= (long)(h ^ (h >> 31));
+                }
+            }
+            return sum;
+        }
+
+        public void Dispose()
+        {
+            _view.Dispose();
+            _file.Dispose();
+        }
+    }
+}
@@ -0,0 +1,77 @@
+using System;
+using System.Buffers.Binary;
+using System.IO;
+using System.IO.Compression;
+
+namespace ToyConEngine
+{
+    // Minimal RGBA8 PNG encoder. Texture2D.SaveAsPng needs a GraphicsDevice, which the
+    // headless host and the export workers do not have.
+    public static class PngWriter
+    {
+        private static readonly byte[] Signature = { 137, 80, 78, 71, 13, 10, 26, 10 };
+        private static readonly uint[] CrcTable = BuildCrcTable();
+
+        public static void Write(Stream stream, ReadOnlySpan<byte> rgba, int width, int height, CompressionLevel level = CompressionLevel.Fastest)
+        {
+            stream.Write(Signature);
+
+            Span<byte> header = stackalloc byte[13];
+            BinaryPrimitives.WriteInt32BigEndian(header, width);
+            BinaryPrimitives.WriteInt32BigEndian(header.Slice(4), height);
+            header[8] = 8;  // bit depth
+            header[9] = 6;  // RGBA
+            header[10] = 0; header[11] = 0; header[12] = 0;
+            WriteChunk(stream, "IHDR", header);
+
+            // Every row gets filter type 0 (none); the pixels are small and mostly flat
+            var data = new MemoryStream(rgba.Length / 2 + 64);
+            using (var z = new ZLibStream(data, level, true))
+            {
+                int stride = width * 4;
+                for (int y = 0; y < height; y++)
+                {
+                    z.WriteByte(0);
+                    z.Write(rgba.Slice(y * stride, stride));
+                }
+            }
+            WriteChunk(stream, "IDAT", data.GetBuffer().AsSpan(0, (int)data.Length));
+            WriteChunk(stream, "IEND", ReadOnlySpan<byte>.Empty);
+        }
+
+        private static void WriteChunk(Stream stream, string type, ReadOnlySpan<byte> payload)
+        {
+            Span<byte> field = stackalloc byte[4];
+            BinaryPrimitives.WriteInt32BigEndian(field, payload.Length);
+            stream.Write(field);
+
+            Span<byte> name = stackalloc byte[4];
+            for (int i = 0; i < 4; i++) name[i] = (byte)type[i];
+            stream.Write(name);
+            stream.Write(payload);
+
+            uint crc = Crc(0xFFFFFFFFu, name);
+            crc = Crc(crc, payload) ^ 0xFFFFFFFFu;
+            BinaryPrimitives.WriteUInt32BigEndian(field, crc);
+            stream.Write(field);
+        }
+
+        private static uint Crc(uint crc, ReadOnlySpan<byte> bytes)
+        {
+            foreach (byte b in bytes) crc = CrcTable[(crc ^ b) & 0xFF] ^ (crc >> 8);
+            return crc;
+        }
+
+        private static uint[] BuildCrcTable()
+        {
+            var table = new uint[256];
+            for (uint n = 0; n < 256; n++)
+            {
+                uint c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) != 0 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            return table;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+
+namespace ToyConEngine
+{
+    // Where presentation mode puts each screen and widget, on a virtual canvas that is
+    // scaled to fit the window. Only elements the user has placed are stored (saved as
+    // VIEW lines in the design); screens that were never placed share a grid over the
+    // canvas and buttons and color swatches stay where they are in the editor.
+    public sealed class PresentationLayout
+    {
+        public const int CanvasWidth = 1280;
+        public const int CanvasHeight = 720;
+        public const int MinSize = 16;
+
+        public Dictionary<Node, Rectangle> Placed { get; } = new Dictionary<Node, Rectangle>();
+
+        // Bumped on every change so the compositor knows to lay out again
+        public int Version { get; private set; }
+
+        public static bool IsPresented(Node node) => node is ScreenNode || node is ButtonNode || node is ColorOutputNode;
+
+        public void Place(Node node, Rectangle rect)
+        {
+            rect.Width = Math.Max(MinSize, rect.Width);
+            rect.Height = Math.Max(MinSize, rect.Height);
+            Placed[node] = rect;
+            Version++;
+        }
+
+        public void Clear()
+        {
+            Placed.Clear();
+            Version++;
+        }
+
+        // Canvas rectangles for every presented node, screens first, otherwise in node-list order
+        public List<(Node Node, Rectangle Rect)> Resolve(List<Node> nodes, Dictionary<Node, Rectangle> editorRects)
+        {
+            var result = new List<(Node, Rectangle)>();
+            var unplaced = new List<ScreenNode>();
+            foreach (var node in nodes)
+            {
+                if (node is ScreenNode s && !Placed.ContainsKey(node)) unplaced.Add(s);
+            }
+
+            // Unplaced screens: the largest square cells that fit them all on the canvas
+            int cols = 1, rows = 1;
+            while (cols * rows < unplaced.Count)
+            {
+                if (CanvasWidth / (cols + 1) >= CanvasHeight / (rows + 1)) cols++;
+                else rows++;
+            }
+            int cell = Math.Min(CanvasWidth / cols, CanvasHeight / rows);
+            int left = (CanvasWidth - cell * cols) / 2, top = (CanvasHeight - cell * rows) / 2;
+            var grid = new Dictionary<Node, Rectangle>();
+            for (int i = 0; i < unplaced.Count; i++)
+                grid[unplaced[i]] = new Rectangle(left + i % cols * cell, top + i / cols * cell, cell, cell);
+
+            // Screens first so widgets are drawn on top of them
+            for (int pass = 0; pass < 2; pass++)
+            {
+                foreach (var node in nodes)
+                {
+                    if (!IsPresented(node) || (node is ScreenNode) != (pass == 0)) continue;
+                    if (Placed.TryGetValue(node, out var rect) || grid.TryGetValue(node, out rect) || editorRects.TryGetValue(node, out rect))
+                        result.Add((node, rect));
+                }
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+using Microsoft.Xna.Framework;
+using Microsoft.Xna.Framework.Graphics;
+using Microsoft.Xna.Framework.Input;
+using System;
+using System.Collections.Generic;
+
+namespace ToyConEngine
+{
+    // The per-frame work of presentation mode and exported games, without the editor.
+    // Screens, buttons and color swatches are laid out once from the design's
+    // PresentationLayout and composited into a render target that keeps its contents
+    // between frames: the background is cleared only when the layout changes,
+    // and after that an element is redrawn only when its content did (a new pipeline frame
+    // for a screen, a press, a different color), together with anything stacked on top of it.
+    // Showing the result is then a single textured quad.
+    public sealed class PresentationRuntime
+    {
+        public const int Border = 2;
+
+        private enum Kind { Screen, Button, Color }
+
+        private sealed class Element
+        {
+            public Node Node;
+            public Kind Kind;
+            public Rectangle Canvas;      // layout position
+            public Rectangle Rect;        // window position
+            public Rectangle Inner;       // inside the border
+            public Vector2 Label;
+            public Texture2D Texture;
+            public bool Dirty = true;
+            public bool Pressed;
+            public Color Color;
+            public int[] Above;           // later elements overlapping this one
+        }
+
+        private ExecutionPlan _plan;
+        private GraphEngine _engine;
+        private PresentationLayout _layout;
+        private int _layoutVersion = -1;
+        private bool _stale = true;
+        private bool _full = true;
+        private Rectangle _bounds;
+        private float _scale = 1;
+        private Point _offset;
+
+        private Element[] _elements = new Element[0];
+        private readonly Dictionary<ScreenNode, Element> _screens = new Dictionary<ScreenNode, Element>();
+        private RenderTarget2D _scene;
+
+        // Layout editing: Ctrl+drag moves an element, Ctrl+wheel resizes it
+        private Element _dragged;
+        private Point _dragOffset;
+
+        // Regions redrawn by the last Compose; 0 when the picture did not change
+        public int LastRedrawn { get; private set; }
+
+        public void Invalidate() => _stale = true;
+
+        public void Sync(GraphEngine engine, Dictionary<Node, Rectangle> rects, PresentationLayout layout, SpriteFont font, Rectangle bounds)
+        {
+            if (!_stale && engine == _engine && engine.Plan == _plan && layout == _layout && layout.Version == _layoutVersion && bounds.Width == _bounds.Width && bounds.Height == _bounds.Height) return;
+            _stale = false;
+            _full = true;
+            _engine = engine;
+            _plan = engine.Plan;
+            _layout = layout;
+            _layoutVersion = layout.Version;
+            _bounds = bounds;
+
+            _scale = Math.Min((float)bounds.Width / PresentationLayout.CanvasWidth, (float)bounds.Height / PresentationLayout.CanvasHeight);
+            _offset = new Point((int)((bounds.Width - PresentationLayout.CanvasWidth * _scale) / 2), (int)((bounds.Height - PresentationLayout.CanvasHeight * _scale) / 2));
+
+            // Screen textures survive a relayout
+            var oldTextures = new Dictionary<ScreenNode, Texture2D>();
+            foreach (var kv in _screens) if (kv.Value.Texture != null) oldTextures[kv.Key] = kv.Value.Texture;
+            _screens.Clear();
+
+            var resolved = layout.Resolve(engine.Nodes, rects);
+            _elements = new Element[resolved.Count];
+            for (int i = 0; i < resolved.Count; i++)
+            {
+                var (node, canvas) = resolved[i];
+                var e = new Element { Node = node, Canvas = canvas, Kind = node is ScreenNode ? Kind.Screen : node is ButtonNode ? Kind.Button : Kind.Color };
+                e.Rect = ToWindow(canvas);
+                e.Inner = new Rectangle(e.Rect.X + Border, e.Rect.Y + Border, Math.Max(0, e.Rect.Width - 2 * Border), Math.Max(0, e.Rect.Height - 2 * Border));
+                if (e.Kind == Kind.Button && font != null) e.Label = e.Rect.Center.ToVector2() - font.MeasureString(node.Name) / 2;
+                if (node is ScreenNode screen)
+                {
+                    oldTextures.TryGetValue(screen, out e.Texture);
+                    _screens[screen] = e;
+                }
+                _elements[i] = e;
+            }
+
+            for (int i = 0; i < _elements.Length; i++)
+            {
+                var above = new List<int>();
+                for (int j = i + 1; j < _elements.Length; j++) if (_elements[j].Rect.Intersects(_elements[i].Rect)) above.Add(j);
+                _elements[i].Above = above.ToArray();
+            }
+        }
+
+        private Rectangle ToWindow(Rectangle canvas) => new Rectangle(
+            _offset.X + (int)(canvas.X * _scale), _offset.Y + (int)(canvas.Y * _scale),
+            (int)Math.Ceiling(canvas.Width * _scale), (int)Math.Ceiling(canvas.Height * _scale));
+
+        private Point ToCanvas(Point window) => new Point((int)((window.X - _offset.X) / _scale), (int)((window.Y - _offset.Y) / _scale));
+
+        public void UpdateInput(MouseState mouse, MouseState previous, bool ctrl)
+        {
+            var pos = mouse.Position;
+            bool down = mouse.LeftButton == ButtonState.Pressed;
+            bool clicked = down && previous.LeftButton == ButtonState.Released;
+
+            if (ctrl || _dragged != null)
+            {
+                EditLayout(mouse, previous, clicked, down);
+                return;
+            }
+
+            bool wasDown = previous.LeftButton == ButtonState.Pressed;
+            foreach (var e in _elements)
+            {
+                if (!(e.Node is ButtonNode btn)) continue;
+                if (btn.IsToggle)
+                {
+                    if (clicked && e.Rect.Contains(pos)) btn.IsPressed = !btn.IsPressed;
+                }
+                else
+                {
+                    // Written only when the mouse takes or lets go of the button, as in the editor
+                    bool held = down && e.Rect.Contains(pos);
+                    if (held != (wasDown && e.Rect.Contains(previous.Position))) btn.IsPressed = held;
+                }
+            }
+        }
+
+        private void EditLayout(MouseState mouse, MouseState previous, bool clicked, bool down)
+        {
+            var pos = mouse.Position;
+            if (clicked)
+            {
+                // Topmost element under the cursor
+                for (int i = _elements.Length - 1; i >= 0 && _dragged == null; i--)
+                {
+                    if (!_elements[i].Rect.Contains(pos)) continue;
+                    _dragged = _elements[i];
+                    var at = ToCanvas(pos);
+                    _dragOffset = new Point(at.X - _dragged.Canvas.X, at.Y - _dragged.Canvas.Y);
+                }
+            }
+
+            if (_dragged != null && down)
+            {
+                var at = ToCanvas(pos);
+                var r = _dragged.Canvas;
+                if (at.X - _dragOffset.X != r.X || at.Y - _dragOffset.Y != r.Y)
+                    _layout.Place(_dragged.Node, new Rectangle(at.X - _dragOffset.X, at.Y - _dragOffset.Y, r.Width, r.Height));
+            }
+            if (!down) _dragged = null;
+
+            int wheel = mouse.ScrollWheelValue - previous.ScrollWheelValue;
+            if (wheel == 0) return;
+            for (int i = _elements.Length - 1; i >= 0; i--)
+            {
+                var e = _elements[i];
+                if (!e.Rect.Contains(pos)) continue;
+                // 10% per notch, around the element's centre
+                float f = wheel > 0 ? 1.1f : 1 / 1.1f;
+                var c = e.Canvas;
+                int w = (int)(c.Width * f), h = (int)(c.Height * f);
+                _layout.Place(e.Node, new Rectangle(c.Center.X - w / 2, c.Center.Y - h / 2, w, h));
+                break;
+            }
+        }
+
+        // Takes the pixels of every shown screen in a pipeline frame
+        public void Upload(GraphicsDevice device, OutputPipeline.Frame frame)
+        {
+            foreach (var (screen, pixels) in frame.Screens)
+            {
+                if (!_screens.TryGetValue(screen, out var e)) continue;
+                e.Texture ??= new Texture2D(device, ScreenNode.Width, ScreenNode.Height);
+                e.Texture.SetData(pixels);
+                e.Dirty = true;
+            }
+        }
+
+        // Brings the scene target up to date. Returns false when nothing had to be redrawn.
+        public bool Compose(GraphicsDevice device, SpriteBatch sb, Texture2D pixel, SpriteFont font)
+        {
+            var pp = device.PresentationParameters;
+            if (_scene == null || _scene.Width != pp.BackBufferWidth || _scene.Height != pp.BackBufferHeight)
+            {
+                _scene?.Dispose();
+                _scene = new RenderTarget2D(device, Math.Max(1, pp.BackBufferWidth), Math.Max(1, pp.BackBufferHeight), false, SurfaceFormat.Color, DepthFormat.None, 0, RenderTargetUsage.PreserveContents);
+                _full = true;
+            }
+
+            foreach (var e in _elements)
+            {
+                if (e.Node is ButtonNode btn && btn.IsPressed != e.Pressed) { e.Pressed = btn.IsPressed; e.Dirty = true; }
+                else if (e.Node is ColorOutputNode col && col.DisplayColor != e.Color) { e.Color = col.DisplayColor; e.Dirty = true; }
+            }
+            // Whatever sits on top of a redrawn element has to be drawn again over it
+            for (int i = 0; i < _elements.Length; i++)
+            {
+                if (!_elements[i].Dirty) continue;
+                foreach (int j in _elements[i].Above) _elements[j].Dirty = true;
+            }
+
+            int redrawn = 0;
+            device.SetRenderTarget(_scene);
+            sb.Begin(samplerState: SamplerState.PointClamp);
+            // Only the background is static; borders belong to their element, since anything
+            // stacked below may paint over them
+            if (_full) device.Clear(Color.Black);
+            foreach (var e in _elements)
+            {
+                if (!_full && !e.Dirty) continue;
+                e.Dirty = false;
+                redrawn++;
+                switch (e.Kind)
+                {
+                    case Kind.Screen:
+                        if (e.Texture != null) sb.Draw(e.Texture, e.Rect, Color.White);
+                        break;
+                    case Kind.Button:
+                        DrawHollowRect(sb, pixel, e.Rect);
+                        sb.Draw(pixel, e.Inner, e.Pressed ? Color.Gray : Color.DarkGray);
+                        if (font != null) sb.DrawString(font, e.Node.Name, e.Label, Color.White);
+                        break;
+                    case Kind.Color:
+                        DrawHollowRect(sb, pixel, e.Rect);
+                        sb.Draw(pixel, e.Inner, e.Color);
+                        break;
+                }
+            }
+            sb.End();
+            device.SetRenderTarget(null);
+
+            _full = false;
+            LastRedrawn = redrawn;
+            return redrawn > 0;
+        }
+
+        // Call inside the caller's SpriteBatch.Begin/End, after Compose
+        public void Present(SpriteBatch sb)
+        {
+            if (_scene != null) sb.Draw(_scene, new Rectangle(0, 0, _scene.Width, _scene.Height), Color.White);
+        }
+
+        private static void DrawHollowRect(SpriteBatch sb, Texture2D pixel, Rectangle rect)
+        {
+            sb.Draw(pixel, new Rectangle(rect.X, rect.Y, rect.Width, Border), Color.White);
+            sb.Draw(pixel, new Rectangle(rect.X, rect.Bottom - Border, rect.Width, Border), Color.White);
+            sb.Draw(pixel, new Rectangle(rect.X, rect.Y, Border, rect.Height), Color.White);
+            sb.Draw(pixel, new Rectangle(rect.Right - Border, rect.Y, Border, rect.Height), Color.White);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+using Microsoft.Xna.Framework;
+using Microsoft.Xna.Framework.Input;
+
+namespace ToyConEngine
+{
+    // Decides whether a frame has to be drawn. A frame is damaged by input, a resized
+    // window, a change to what the game reports as visible (its signature: port values,
+    // colors) or an explicit Invalidate; undamaged frames skip Draw. After IdleFrames
+    // undamaged frames in a row the tracker reports IsIdle, which the game uses to run
+    // Update less often until the next damage. A Refresh draws one frame without counting
+    // as damage, for readouts like the FPS counter that change on their own while idle;
+    // KeepAwake does the opposite, holding off idle without a draw while output that does
+    // not show on screen (audio, streams to other processes) is being produced.
+    public sealed class RedrawTracker
+    {
+        public const int IdleFrames = 30;
+
+        private bool _damaged = true;
+        private bool _refresh;
+        private bool _awake;
+        private int _quietFrames;
+        private long _signature;
+        private MouseState _mouse;
+        private KeyboardState _keyboard;
+        private Rectangle _bounds;
+
+        public bool IsIdle => _quietFrames >= IdleFrames;
+        public long FramesSkipped { get; private set; }
+
+        public void Invalidate() => _damaged = true;
+
+        public void Refresh() => _refresh = true;
+
+        public void KeepAwake() => _awake = true;
+
+        public void Observe(MouseState mouse, KeyboardState keyboard, Rectangle bounds)
+        {
+            if (mouse != _mouse || keyboard != _keyboard || bounds != _bounds) _damaged = true;
+            _mouse = mouse;
+            _keyboard = keyboard;
+            _bounds = bounds;
+        }
+
+        public void Observe(long signature)
+        {
+            if (signature != _signature) _damaged = true;
+            _signature = signature;
+        }
+
+        // Ends the frame's observations; true when it must be drawn
+        public bool EndFrame()
+        {
+            bool damaged = _damaged, refresh = _refresh, awake = _awake;
+            _damaged = _refresh = _awake = false;
+            if (damaged || awake) _quietFrames = 0;
+            else if (_quietFrames < IdleFrames) _quietFrames++;
+            if (!damaged && !refresh) FramesSkipped++;
+            return damaged || refresh;
+        }
+    }
+}
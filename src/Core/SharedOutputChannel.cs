@@ -0,0 +1,137 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+using System.Text;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Publishes SharedOutputNode ports and ScreenNode framebuffers into a file-backed
+    // memory-mapped ring so other local processes (see tools/toyshm.h) can read every tick.
+    //
+    // Layout, little-endian:
+    //   header (HeaderSize bytes): "TOYSHM01", u32 header_size, slot_count, slot_size,
+    //     port_count, screen_width, screen_height, screen_count, then at WriteIndexOffset
+    //     u64 write_index = number of slots published so far
+    //   slot i at header_size + i * slot_size: u64 seq, u64 tick, f32 ports[port_count],
+    //     then at PixelsOffset u32 rgba pixels[screen_count][height][width]
+    //
+    // Each slot is a seqlock: seq is odd while it is being written and even once done.
+    // The engine never waits for readers; a reader that was lapped sees seq change and retries.
+    public sealed class SharedOutputChannel : IDisposable
+    {
+        public const int PortCount = 64;
+        public const int HeaderSize = 128;
+        public const int WriteIndexOffset = 64;
+        public const int PortsOffset = 16;
+        public const int PixelsOffset = PortsOffset + PortCount * sizeof(float);
+        public static readonly byte[] Magic = Encoding.ASCII.GetBytes("TOYSHM01");
+
+        public static string DefaultPath => Directory.Exists("/dev/shm")
+            ? "/dev/shm/toycon_output"
+            : Path.Combine(Path.GetTempPath(), "toycon_output.shm");
+
+        public string FilePath { get; }
+        public int SlotCount { get; }
+        public int ScreenCount { get; }
+        public int SlotSize { get; }
+        public long Published { get; private set; }
+
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+
+        // Sinks are looked up again only when the engine recompiles its plan
+        private ExecutionPlan _plan;
+        private readonly List<SharedOutputNode> _sinks = new List<SharedOutputNode>();
+        private readonly List<ScreenNode> _screens = new List<ScreenNode>();
+        // Slots still holding ports of a sink that has since been removed or moved
+        private int _staleSlots;
+        private static readonly float[] ZeroPorts = new float[PortCount];
+
+        public SharedOutputChannel(string path, int slotCount = 8, int screenCount = 1)
+        {
+            FilePath = path;
+            SlotCount = slotCount;
+            ScreenCount = screenCount;
+            // Slots are cache-line aligned so a reader of one slot does not share lines with the writer
+            SlotSize = (PixelsOffset + screenCount * ScreenNode.Width * ScreenNode.Height * 4 + 63) & ~63;
+
+            long capacity = HeaderSize + (long)slotCount * SlotSize;
+            _file = MemoryMappedFile.CreateFromFile(path, FileMode.Create, null, capacity, MemoryMappedFileAccess.ReadWrite);
+            _view = _file.CreateViewAccessor(0, capacity);
+
+            _view.WriteArray(0, Magic, 0, Magic.Length);
+            _view.Write(8, HeaderSize);
+            _view.Write(12, slotCount);
+            _view.Write(16, SlotSize);
+            _view.Write(20, PortCount);
+            _view.Write(24, ScreenNode.Width);
+            _view.Write(28, ScreenNode.Height);
+            _view.Write(32, screenCount);
+            _view.Write(WriteIndexOffset, 0L);
+        }
+
+        // Hook for GraphEngine.Ticked
+        public void Publish(GraphEngine engine) => Publish(engine, engine.TickCount);
+
+        public void Publish(GraphEngine engine, long tick)
+        {
+            var plan = engine.Plan;
+            if (plan != _plan) FindSinks(engine, plan);
+
+            long index = Published;
+            long slot = HeaderSize + (index % SlotCount) * SlotSize;
+            long seq = _view.ReadInt64(slot);
+
+            _view.Write(slot, seq + 1);
+            Thread.MemoryBarrier();
+
+            _view.Write(slot + 8, tick);
+            if (_staleSlots > 0)
+            {
+                _view.WriteArray(slot + PortsOffset, ZeroPorts, 0, PortCount);
+                _staleSlots--;
+            }
+            // Port values go straight from the wires into the slot
+            foreach (var sink in _sinks)
+            {
+                if (sink.Bank < 0 || sink.Bank >= SharedOutputNode.BankCount) continue;
+                long ports = slot + PortsOffset + sink.Bank * SharedOutputNode.PortsPerBank * sizeof(float);
+                for (int i = 0; i < sink.Inputs.Count; i++) _view.Write(ports + i * sizeof(float), sink.Inputs[i].GetValue());
+            }
+            for (int s = 0; s < _screens.Count; s++)
+            {
+                // One memmove per framebuffer, straight from the node's array
+                var pixels = MemoryMarshal.AsBytes(_screens[s].Buffer.AsSpan());
+                _view.SafeMemoryMappedViewHandle.WriteSpan<byte>((ulong)(_view.PointerOffset + slot + PixelsOffset + (long)s * pixels.Length), pixels);
+            }
+
+            Thread.MemoryBarrier();
+            _view.Write(slot, seq + 2);
+            Published = index + 1;
+            _view.Write(WriteIndexOffset, Published);
+        }
+
+        private void FindSinks(GraphEngine engine, ExecutionPlan plan)
+        {
+            _plan = plan;
+            _staleSlots = SlotCount;
+            _sinks.Clear();
+            _screens.Clear();
+            foreach (var node in engine.Nodes)
+            {
+                if (node is SharedOutputNode sink) _sinks.Add(sink);
+                else if (node is ScreenNode screen && _screens.Count < ScreenCount) _screens.Add(screen);
+            }
+        }
+
+        public void Dispose()
+        {
+            _view.Dispose();
+            _file.Dispose();
+        }
+    }
+}
@@ -0,0 +1,69 @@
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace ToyConEngine
+{
+    // Bounded single-producer/single-consumer ring. Only the producer writes the tail and
+    // only the consumer writes the head, so neither side takes a lock or an interlocked op;
+    // each keeps a cached copy of the other's index and rereads it only when the ring looks
+    // full (or empty).
+    public sealed class SpscQueue<T>
+    {
+        private readonly T[] _items;
+        private readonly int _mask;
+        private SpscIndices _indices;
+        private long _cachedHead; // producer side
+        private long _cachedTail; // consumer side
+
+        public int Capacity => _items.Length;
+        public int Count => (int)(Volatile.Read(ref _indices.Tail) - Volatile.Read(ref _indices.Head));
+
+        // Rounded up to a power of two
+        public SpscQueue(int capacity)
+        {
+            int size = 1;
+            while (size < Math.Max(2, capacity)) size <<= 1;
+            _items = new T[size];
+            _mask = size - 1;
+        }
+
+        // Producer only
+        public bool TryEnqueue(T item)
+        {
+            long tail = _indices.Tail;
+            if (tail - _cachedHead == _items.Length)
+            {
+                _cachedHead = Volatile.Read(ref _indices.Head);
+                if (tail - _cachedHead == _items.Length) return false;
+            }
+            _items[tail & _mask] = item;
+            Volatile.Write(ref _indices.Tail, tail + 1);
+            return true;
+        }
+
+        // Consumer only
+        public bool TryDequeue(out T item)
+        {
+            long head = _indices.Head;
+            if (head == _cachedTail)
+            {
+                _cachedTail = Volatile.Read(ref _indices.Tail);
+                if (head == _cachedTail) { item = default; return false; }
+            }
+            item = _items[head & _mask];
+            _items[head & _mask] = default;
+            Volatile.Write(ref _indices.Head, head + 1);
+            return true;
+        }
+    }
+
+    // Head and tail on separate cache lines so the two threads do not bounce one line.
+    // Outside SpscQueue<T> because generic types cannot have an explicit layout.
+    [StructLayout(LayoutKind.Explicit, Size = 192)]
+    internal struct SpscIndices
+    {
+        [FieldOffset(64)] public long Head;
+        [FieldOffset(128)] public long Tail;
+    }
+}
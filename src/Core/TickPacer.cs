@@ -0,0 +1,63 @@
+using System;
+
+namespace ToyConEngine
+{
+    // Closed-loop choice of ticks per frame. Every frame reports how many ticks it ran, how
+    // long they took and how long the rest of the frame's work (input, UI, drawing) took;
+    // both costs are smoothed, and the next frame gets as many ticks as fit in
+    // BudgetFraction of the frame period after the other work. Outside a small dead band the
+    // count shrinks at once (immediately on an overrun) but grows by at most MaxGrowth per
+    // frame, so the frame cadence (and vsync) holds instead of oscillating.
+    public sealed class TickPacer
+    {
+        public const int MaxTicksPerFrame = 1 << 20;
+        public const double MaxGrowth = 1.25;
+        // Ideal counts within this fraction of the current one leave it alone
+        public const double DeadBand = 0.05;
+        private const double Smoothing = 0.2;
+
+        private double _budgetFraction = 0.75;
+        public double BudgetFraction
+        {
+            get => _budgetFraction;
+            set => _budgetFraction = Math.Clamp(value, 0.05, 0.95);
+        }
+
+        public int TicksPerFrame { get; private set; } = 1;
+        // Smoothed seconds per tick and per frame of non-tick work
+        public double TickCost { get; private set; }
+        public double FrameOverhead { get; private set; }
+        public double Period { get; private set; }
+        // Share of the last frame period spent ticking
+        public double Utilization { get; private set; }
+        public long Overruns { get; private set; }
+
+        public void Update(double period, int ticks, double tickSeconds, double otherSeconds)
+        {
+            Period = period;
+            if (period <= 0) return;
+
+            if (ticks > 0)
+            {
+                double cost = tickSeconds / ticks;
+                // A slower tick is believed at once, a faster one only gradually
+                TickCost = cost > TickCost ? cost : TickCost + (cost - TickCost) * Smoothing;
+            }
+            otherSeconds = Math.Max(0, otherSeconds);
+            FrameOverhead = FrameOverhead == 0 ? otherSeconds : FrameOverhead + (otherSeconds - FrameOverhead) * Smoothing;
+            Utilization = tickSeconds / period;
+            bool overran = tickSeconds + otherSeconds > period;
+            if (overran) Overruns++;
+
+            double budget = period * _budgetFraction - FrameOverhead;
+            int ideal = budget <= 0 || TickCost <= 0 ? 1 : (int)Math.Clamp(budget / TickCost, 1, MaxTicksPerFrame);
+
+            if (ideal < TicksPerFrame && (overran || ideal < TicksPerFrame * (1 - DeadBand))) TicksPerFrame = ideal;
+            else if (ideal > TicksPerFrame * (1 + DeadBand))
+                TicksPerFrame = Math.Min(ideal, Math.Max(TicksPerFrame + 1, (int)(TicksPerFrame * MaxGrowth)));
+        }
+
+        public override string ToString() =>
+            $"{TicksPerFrame} ticks/frame, {TickCost * 1e6:F2}us/tick, {Utilization:P0} of {Period * 1000:F1}ms (target {_budgetFraction:P0}), {Overruns} overruns";
+    }
+}
@@ -11,6 +11,7 @@ using System.Runtime.InteropServices;
 using System.Text;
 using System.Text.RegularExpressions;
 using System.Threading;
+using System.Threading.Tasks;
 
 namespace ToyConEngine
 {
@@ -18,7 +19,6 @@ namespace ToyConEngine
     public class ToyConGame : Game
     {
 
-        private Random rnd = new Random();
         public static Rectangle ClientBounds { get; private set; }
         private GraphicsDeviceManager _graphics;
         private SpriteBatch _spriteBatch;
@@ -37,20 +37,32 @@ namespace ToyConEngine
         private class ConnectionData { public int TargetNodeIdx; public int TargetInputIdx; public int SourceNodeIdx; public int SourceOutputIdx; }
         private List<ConnectionData> _clipboardConnections = new List<ConnectionData>();
 
+        // _engine and _nodeRects always belong to the workspace's active tab
+        private Workspace _workspace;
         private GraphEngine _engine;
 
         // Visual State
-        private Dictionary<Node, Rectangle> _nodeRects = new Dictionary<Node, Rectangle>();
+        private Dictionary<Node, Rectangle> _nodeRects;
         private bool _isDraggingNodes = false;
         private Point _lastMousePos;
         private bool _presentationMode = false;
         private Dictionary<ScreenNode, Texture2D> _screenTextures = new Dictionary<ScreenNode, Texture2D>();
+
+        // Auto layout runs on a worker; while _autoLayout is on (script-generated graphs) edits re-run it incrementally
+        private Task<Dictionary<Node, Point>> _layoutTask;
+        private bool _layoutPending;
+        private bool _layoutPendingIncremental;
+        private bool _autoLayout = false;
+        // Last saved/loaded state of the main graph; Save Patch diffs against it
+        private GraphSnapshot _baseline;
         private KeyboardState _prevKeyboardState;
         private MouseState _prevMouseState;
 
         private string _activeMenu = null;
         private Dictionary<string, List<(string Name, Func<Node> Factory)>> _menus;
         private Rectangle _uiBarRect = new Rectangle(0, 0, 800, 30);
+        private const int TabWidth = 160;
+        private const int TabHeight = 22;
 
         private Node _inspectedNode = null;
         private Rectangle _overlayRect;
@@ -61,12 +73,33 @@ namespace ToyConEngine
         private Node _connectionStartNode = null;
         private int _connectionStartIndex = -1;
         private string _inputValueBuffer = "";
-        private bool _benchmarkMode = false;
-        private string _benchmarkResult = "";
+
+        // A size typed into the MemoryNode inspector; resizing truncates the data, so it is
+        // applied on Enter or when the field loses focus rather than on every keystroke
+        private MemoryNode _sizeEditOwner;
+        private MemoryNode[] _sizeEditNodes;
+        private GraphEngine _sizeEditEngine;
+        private int _sizeEditValue;
+        private bool _isStandalone = false;
+        private Autosaver _autosaver;
+        // Open while File > Share Output is on; publishes the active design after every tick
+        private SharedOutputChannel _sharedOutput;
+        // Open while File > Input Socket is on; feeds injected input into the active design
+        private InputInjector _injector;
+        // Open while File > Record Video is on; records the active design's first screen
+        private FrameExporter _recorder;
+        // Plays beeps, counts ticks and hands screen frames to Draw off the tick (see OutputPipeline)
+        private OutputPipeline _outputs;
+        // Presentation mode and exported games draw and hit-test through this instead of the editor
+        private readonly PresentationRuntime _presentation = new PresentationRuntime();
+        private readonly ToyThumbnailCache _toyThumbnails = new ToyThumbnailCache();
+        private readonly Dictionary<string, SoundEffect> _sounds = new Dictionary<string, SoundEffect>();
+        // Last File > Analyze report, shown in the bottom-left corner until the next click
+        private string _analysisResult;
+        private long _editsFailedSeen;
         
         private const string StandaloneMagic = "TOYCON_PKG";
 
-        private double nsPerTick = 0;
         private int _tpsCount = 0;
         private double _tpsElapsed = 0;
         private string _tpsString = "TPS: 0";
@@ -74,8 +107,20 @@ namespace ToyConEngine
         private const int MaxTpsHistory = 60;
 
 
-        private double tps = 60;
-        private bool optimized = false;
+        // Picks ticks per frame from measured tick and frame cost (see TickPacer)
+        private readonly TickPacer _pacer = new TickPacer();
+        private TimeSpan _simTime;
+        private long _frameStart;
+        private int _lastTicks;
+        private double _lastTickSeconds, _lastFrameWork;
+
+        // Frames with nothing new to show are not drawn, and once the editor has been idle
+        // for a while, with no audio or other outside output either, Update drops to IdlePeriod
+        // until the next input or visible change
+        private static readonly TimeSpan FramePeriod = TimeSpan.FromSeconds(1.0 / 60);
+        private static readonly TimeSpan IdlePeriod = TimeSpan.FromSeconds(1.0 / 10);
+        private readonly RedrawTracker _redraw = new RedrawTracker();
+        private long _beepsSeen;
 
         public ToyConGame()
         {
@@ -84,18 +129,18 @@ namespace ToyConEngine
             IsMouseVisible = true;
             Window.AllowUserResizing = true;
             Window.Title = "ToyCon Engine - MonoGame Port";
-        }
 
-        private void setupBench() {
-            _graphics.SynchronizeWithVerticalRetrace = false;
-            _benchmarkMode = !_benchmarkMode; 
-            _benchmarkResult = "Benchmarking...";
-            optimized = false;
+            // A steady 60 Hz frame; throughput comes from the ticks the pacer fits into each frame
+            _graphics.SynchronizeWithVerticalRetrace = true;
+            IsFixedTimeStep = true;
+            TargetElapsedTime = FramePeriod;
         }
 
         protected override void Initialize()
         {
-            _engine = new GraphEngine();
+            _workspace = new Workspace();
+            _engine = _workspace.Active.Engine;
+            _nodeRects = _workspace.Active.Rects;
 
             _menus = new Dictionary<string, List<(string Name, Func<Node> Factory)>>
             {
@@ -104,20 +149,74 @@ namespace ToyConEngine
                         var path = PromptForSavePath("design.toy", "Nintendo Labo ToyCon Garage Design File|*.toy");
                         SaveLayout(path);
                         return null; }),
+                    ("Save Compressed", () => {
+                        var path = PromptForSavePath("design.toy", "Nintendo Labo ToyCon Garage Design File|*.toy");
+                        SaveLayout(path, DesignCompression.Brotli);
+                        return null; }),
                     ("Load", () => { 
-                        var path = PromptForOpenPath("design.toy", "Nintendo Labo ToyCon Garage Design File|*.toy");
+                        var path = PromptForOpenPath("Nintendo Labo ToyCon Garage Design File|*.toy");
                         LoadLayout(path);
                         return null; }),
-                    ("Benchmark", () => { 
-                        setupBench();
-                        return null; 
+                    ("Save Patch", () => {
+                        var path = PromptForSavePath("design.toypatch", "ToyCon Design Patch|*.toypatch");
+                        SavePatch(path);
+                        return null; }),
+                    ("Apply Patch", () => {
+                        var path = PromptForOpenPath("ToyCon Design Patch|*.toypatch");
+                        ApplyPatch(path);
+                        return null; }),
+                    ("Share Output", () => {
+                        ToggleSharedOutput();
+                        return null; }),
+                    ("Input Socket", () => {
+                        ToggleInputInjector();
+                        return null; }),
+                    ("Record Video", () => {
+                        ToggleRecording();
+                        return null; }),
+                    ("Analyze", () => {
+                        AnalyzeGraph();
+                        return null; }),
+                    ("Auto Layout", () => {
+                        _autoLayout = true;
+                        RequestLayout(false);
+                        return null;
+                    }),
+                    ("Tick Budget", () => {
+                        // 50% -> 75% -> 90% of each frame spent ticking
+                        _pacer.BudgetFraction = _pacer.BudgetFraction >= 0.9 ? 0.5 : _pacer.BudgetFraction >= 0.75 ? 0.9 : 0.75;
+                        return null;
                     }),
                     ("Export EXE", () => { 
                         var path = PromptForSavePath("ToyCon_Export.exe", "Executable|*.exe");
                         if (path != null) ExportStandalone(path); 
                         return null; 
                     }),
-                    ("Clear", () => { _engine.Nodes.Clear(); _nodeRects.Clear(); _selectedNodes.Clear(); _inspectedNode = null; return null; })
+                    ("Clear", () => { ClearGraph(); _autoLayout = false; return null; })
+                }},
+                { "Design", new List<(string, Func<Node>)> {
+                    ("New Tab", () => {
+                        _workspace.Add($"Design {_workspace.Tabs.Count + 1}");
+                        SwitchTab(_workspace.Tabs.Count - 1);
+                        return null; }),
+                    ("Open In Tab", () => {
+                        var path = PromptForOpenPath("Nintendo Labo ToyCon Garage Design File|*.toy");
+                        if (path == null) return null;
+                        _workspace.Add(Path.GetFileNameWithoutExtension(path)).FilePath = path;
+                        SwitchTab(_workspace.Tabs.Count - 1);
+                        LoadLayout(path);
+                        return null; }),
+                    ("Close Tab", () => {
+                        CloseTab();
+                        return null; }),
+                    ("Tick Rate", () => {
+                        // 30 -> 60 -> 120 -> 240 Hz while in the background
+                        var tab = _workspace.Active;
+                        tab.TickRate = tab.TickRate >= 240 ? 30 : tab.TickRate * 2;
+                        return null; }),
+                    ("Priority", () => {
+                        _workspace.Active.Priority = (_workspace.Active.Priority + 1) % 4;
+                        return null; })
                 }},
                 { "Input", new List<(string, Func<Node>)> {
                     ("Constant", () => new ConstantNode(1.0f)),
@@ -130,17 +229,21 @@ namespace ToyConEngine
                 }},
                 { "Middle", new List<(string, Func<Node>)> {
                     ("Math", () => new MathNode(MathNode.Operation.Add)),
+                    ("Sum", () => new AggregateNode(AggregateNode.AggregateType.Sum, 3)),
                     ("Logic", () => new LogicNode(LogicNode.LogicType.And)),
-                    ("Counter", () => new CounterNode())
+                    ("Counter", () => new CounterNode()),
+                    ("Memory", () => new MemoryNode())
                 }},
                 { "Output", new List<(string, Func<Node>)> {
                     ("Color", () => new ColorOutputNode()),
                     ("Beep", () => new BeepOutputNode()),
                     ("Screen", () => new ScreenNode()),
-                    ("Toy Output", () => new ToyOutputNode())
+                    ("Toy Output", () => new ToyOutputNode()),
+                    ("Shared Out", () => new SharedOutputNode())
                 }},
                 { "Import", new List<(string, Func<Node>)> {
                     ("Script", () => new ScriptImporterNode()),
+                    ("Data File", () => new DataFileNode()),
                     ("Toy Project", () => new ToyNode())
                 }}
             };
@@ -148,7 +251,9 @@ namespace ToyConEngine
             base.Initialize();
             
             // Check if this is a standalone build with embedded data
-            if (TryLoadEmbeddedLayout()) _presentationMode = true;
+            if (TryLoadEmbeddedLayout()) { _presentationMode = true; _isStandalone = true; _presentation.Invalidate(); }
+
+            _autosaver = new Autosaver(Path.Combine(AppDomain.CurrentDomain.BaseDirectory, "autosave"));
         }
 
         protected override void LoadContent()
@@ -179,110 +284,174 @@ namespace ToyConEngine
                     try
                     {
                         // Try to load as SoundEffect to verify type
-                        Content.Load<SoundEffect>(assetName);
+                        _sounds[assetName] = Content.Load<SoundEffect>(assetName);
                         _availableSounds.Add(assetName);
                     }
                     catch { }
                 }
             }
             if (_availableSounds.Count == 0) _availableSounds.Add("Beep");
-        }
 
-        private void benchBiotch(GameTime gameTime) {
-            if (!optimized) { nsPerTick = (gameTime.TotalGameTime.TotalSeconds - gameTime.ElapsedGameTime.TotalSeconds)/16; }
-            if  (_benchmarkMode || ((rnd.Next(0,100000000) > 98969492)&&!optimized))
+            // Sounds are all loaded up front, so the audio stage never touches the ContentManager
+            _outputs = new OutputPipeline(beep =>
             {
-                if (!_benchmarkMode) TargetElapsedTime = TimeSpan.FromSeconds(1.0 / (10000*nsPerTick));
-                // Run benchmark: execute Tick as many times as possible in 25ms
-                int iterations = 0;
-                var sw = Stopwatch.StartNew();
-                long limitMs = rnd.Next(0,42066964)/10000000;
+                if (_sounds.TryGetValue(beep.SoundName, out var sfx)) sfx.Play(beep.Volume, beep.Pitch, 0);
+            });
+            _engine.Ticked += _outputs.Publish;
+        }
 
-                while (sw.ElapsedMilliseconds < limitMs)
-                {
-                    _engine.Tick(gameTime);
-                    iterations++;
-                    _tpsCount++;
-                }
-                sw.Stop();
+        protected override void UnloadContent()
+        {
+            _outputs?.Dispose();
+            _toyThumbnails.Dispose();
+            base.UnloadContent();
+        }
 
-                tps = iterations / sw.Elapsed.TotalSeconds;
-                nsPerTick = 1000000.0 / tps;
+        // Runs the pacer's tick count for this frame, sharing the frame's elapsed time out
+        // between the ticks so timers keep real time however many ticks run
+        private void RunTicks(GameTime gameTime)
+        {
+            // Ticks per frame are planned for the frame period in use, so an idle editor runs
+            // as many ticks per second as an active one, just in fewer and larger batches
+            _pacer.Update(TargetElapsedTime.TotalSeconds, _lastTicks, _lastTickSeconds, _lastFrameWork - _lastTickSeconds);
+
+            int ticks = _pacer.TicksPerFrame;
+            // Each tick ends at its exact share of the frame, so integer division never loses
+            // time: steps differ by at most one TimeSpan tick and always add up to the frame
+            long frameStart = _simTime.Ticks;
+            long elapsed = gameTime.ElapsedGameTime.Ticks;
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < ticks; i++)
+            {
+                var end = TimeSpan.FromTicks(frameStart + elapsed * (i + 1) / ticks);
+                var step = end - _simTime;
+                _simTime = end;
+                _engine.Tick(new GameTime(_simTime, step));
+            }
+            _lastTickSeconds = Stopwatch.GetElapsedTime(start).TotalSeconds;
+            _lastTicks = ticks;
+            _tpsCount += ticks;
+        }
 
-                _benchmarkResult = $"Magic Number: {nsPerTick:F8}ns\n({tps:F0} TPS)";
-                _benchmarkMode = false;
-            }
-            else
-            {
-                _engine.Tick(new GameTime(new TimeSpan(), new TimeSpan((long)nsPerTick)));
-                _tpsCount++;
-            }
-            if (tps > 1152000) { optimized=true; _engine.Tick(gameTime); } else { optimized = false;  _engine.Tick(new GameTime(new TimeSpan(), new TimeSpan((long)nsPerTick))); }
+        // Frame work is measured up to here, before the present that may wait for vsync
+        protected override void EndDraw()
+        {
+            _lastFrameWork = Stopwatch.GetElapsedTime(_frameStart).TotalSeconds;
+            base.EndDraw();
         }
 
         protected override void Update(GameTime gameTime)
         {
+            _frameStart = Stopwatch.GetTimestamp();
             ClientBounds = Window.ClientBounds;
             var mouseState = Mouse.GetState();
             var mousePos = mouseState.Position;
             var keyboardState = Keyboard.GetState();
+            InputSnapshot.Capture(keyboardState, mouseState);
 
-            // Update ButtonNodes
-            foreach (var kvp in _nodeRects)
+            if (_layoutTask != null && _layoutTask.IsCompleted) ApplyLayout();
+
+            // Dead nodes only run while editing, where they may be about to get wired up
+            _engine.PruneDeadNodes = _presentationMode;
+
+            if (_presentationMode)
+            {
+                // Ctrl+drag moves a screen or widget, Ctrl+wheel resizes it
+                bool editLayout = !_isStandalone && (keyboardState.IsKeyDown(Keys.LeftControl) || keyboardState.IsKeyDown(Keys.RightControl));
+                _presentation.Sync(_engine, _nodeRects, _workspace.Active.Layout, _font, ClientBounds);
+                _presentation.UpdateInput(mouseState, _prevMouseState, editLayout);
+            }
+            else
             {
-                if (kvp.Key is ButtonNode btnNode)
+                // Update ButtonNodes
+                foreach (var kvp in _nodeRects)
                 {
-                    if (btnNode.IsToggle)
+                    if (kvp.Key is ButtonNode btnNode)
                     {
-                        if (kvp.Value.Contains(mousePos) && mouseState.LeftButton == ButtonState.Pressed && _prevMouseState.LeftButton == ButtonState.Released)
-                            btnNode.IsPressed = !btnNode.IsPressed;
-                    }
-                    else
-                    {
-                        btnNode.IsPressed = kvp.Value.Contains(mousePos) && mouseState.LeftButton == ButtonState.Pressed;
+                        if (btnNode.IsToggle)
+                        {
+                            if (kvp.Value.Contains(mousePos) && mouseState.LeftButton == ButtonState.Pressed && _prevMouseState.LeftButton == ButtonState.Released)
+                                btnNode.IsPressed = !btnNode.IsPressed;
+                        }
+                        else
+                        {
+                            // Only on a change of the mouse's hold on the button, so a pressed
+                            // state injected from a recording or the network is not cleared every frame
+                            bool held = kvp.Value.Contains(mousePos) && mouseState.LeftButton == ButtonState.Pressed;
+                            bool wasHeld = kvp.Value.Contains(_prevMouseState.Position) && _prevMouseState.LeftButton == ButtonState.Pressed;
+                            if (held != wasHeld) btnNode.IsPressed = held;
+                        }
                     }
                 }
             }
 
             // 1. Logic Tick
-            benchBiotch(gameTime);
+            RunTicks(gameTime);
+            _workspace.RunBackground(gameTime.ElapsedGameTime.TotalSeconds);
+            if (_engine.EditsFailed != _editsFailedSeen)
+            {
+                _editsFailedSeen = _engine.EditsFailed;
+                _analysisResult = $"An edit could not be applied: {_engine.LastEditError.Message}";
+            }
+
+            // Between ticks the graph is consistent, so this is where autosave snapshots it
+            if (!_isStandalone)
+                _autosaver.Update(gameTime.ElapsedGameTime.TotalSeconds, () => _engine.Nodes.Count > 0
+                    ? GraphSnapshot.CaptureState(_engine, _nodeRects, DesignLoader.CaptureNodeState, _workspace.Active.Layout) : null);
 
             _tpsElapsed += gameTime.ElapsedGameTime.TotalSeconds;
             if (_tpsElapsed >= 1.0)
             {
-                _tpsString = $"FPS: {_tpsCount}";
+                _tpsString = $"FPS: {_tpsCount}  TPS: {_outputs.TicksPerSecond:F0}";
                 _tpsHistory.Add(_tpsCount);
                 if (_tpsHistory.Count > MaxTpsHistory) _tpsHistory.RemoveAt(0);
                 _tpsCount = 0;
                 _tpsElapsed -= 1.0;
+                _redraw.Refresh();
             }
 
-            // 2. Handle Audio Outputs
-            foreach (var node in _engine.Nodes)
+            // 2. Audio Outputs are played per tick by the pipeline's audio stage
+
+            // Skip drawing when nothing on screen would change
+            _redraw.Observe(mouseState, keyboardState, ClientBounds);
+            _redraw.Observe(VisibleSignature());
+            if (_outputs.HasFrame) _redraw.Invalidate();
+            // Output that leaves the window has to keep its per-frame timing, so it never idles
+            if (_outputs.BeepsPosted != _beepsSeen || _sharedOutput != null || _recorder != null || _injector != null || _engine.HasAsyncWork)
+                _redraw.KeepAwake();
+            _beepsSeen = _outputs.BeepsPosted;
+            if (!_redraw.EndFrame())
             {
-                if (node is BeepOutputNode beepNode && beepNode.ShouldPlay)
-                {
-                    try
-                    {
-                        var sfx = Content.Load<SoundEffect>(beepNode.SoundName);
-                        sfx.Play(beepNode.Volume, beepNode.Pitch, 0);
-                    }
-                    catch { }
-                }
+                SuppressDraw();
+                _lastFrameWork = Stopwatch.GetElapsedTime(_frameStart).TotalSeconds;
+            }
+            TargetElapsedTime = _redraw.IsIdle ? IdlePeriod : FramePeriod;
+
+            if (_presentationMode)
+            {
+                // No editor bookkeeping; F5 is the only shortcut
+                if (IsKeyPressed(keyboardState, Keys.F5)) { _presentationMode = false; _outputs.Resend(); }
+                _prevKeyboardState = keyboardState;
+                _prevMouseState = mouseState;
+                base.Update(gameTime);
+                return;
             }
 
             // 3. Input Handling (Drag and Drop)
             bool clicked = mouseState.LeftButton == ButtonState.Pressed && _prevMouseState.LeftButton == ButtonState.Released;
             bool rightClicked = mouseState.RightButton == ButtonState.Pressed && _prevMouseState.RightButton == ButtonState.Released;
+            if (clicked && _activeMenu == null) _analysisResult = null;
 
             // Shortcuts
             bool ctrl = keyboardState.IsKeyDown(Keys.LeftControl) || keyboardState.IsKeyDown(Keys.RightControl);
             if (IsKeyPressed(keyboardState, Keys.Delete)) DeleteSelectedNodes();
-            if (IsKeyPressed(keyboardState, Keys.F5)) _presentationMode = !_presentationMode;
+            if (IsKeyPressed(keyboardState, Keys.F5)) { _presentationMode = true; _presentation.Invalidate(); _outputs.Resend(); }
 
             if (ctrl && IsKeyPressed(keyboardState, Keys.C)) CopyNodes();
             if (ctrl && IsKeyPressed(keyboardState, Keys.V)) PasteNodes();
 
+            if (_sizeEditOwner != null && _inspectedNode != _sizeEditOwner) CommitMemorySize();
+
             if (_inspectedNode != null)
             {
                 UpdateOverlay(mouseState, keyboardState, clicked);
@@ -293,8 +462,6 @@ namespace ToyConEngine
                 return;
             }
 
-            if (_presentationMode) return; // Skip UI updates in presentation mode
-
             bool uiCaptured = UpdateUI(mouseState);
 
             // Handle Connection Dragging Start
@@ -333,7 +500,15 @@ namespace ToyConEngine
                             Rectangle portRect = new Rectangle((int)portPos.X - 6, (int)portPos.Y - 6, 12, 12);
                             if (portRect.Contains(mousePos))
                             {
-                                _engine.Connect(_connectionStartNode, _connectionStartIndex, node, i);
+                                var (source, sourceSlot, targetSlot) = (_connectionStartNode, _connectionStartIndex, i);
+                                _engine.Post(e =>
+                                {
+                                    // Either end may have been deleted or lost the port by the time this runs
+                                    if (e.FindNode(source.Id) != source || e.FindNode(node.Id) != node) return;
+                                    if (sourceSlot >= source.Outputs.Count || targetSlot >= node.Inputs.Count) return;
+                                    e.Connect(source, sourceSlot, node, targetSlot);
+                                    OnGraphEdited();
+                                });
                                 break;
                             }
                         }
@@ -373,6 +548,7 @@ namespace ToyConEngine
                                 _inputValueBuffer = "";
                                 if (_inspectedNode is ConstantNode c) _inputValueBuffer = c.StoredValue.ToString();
                                 if (_inspectedNode is CounterNode cnt) _inputValueBuffer = cnt.Value.ToString();
+                                if (_inspectedNode is MemoryNode mem) _inputValueBuffer = mem.Size.ToString();
                                 if (_inspectedNode is ScriptImporterNode sn) _inputValueBuffer = sn.Script;
                                 doubleClickHandled = true;
                             }
@@ -396,7 +572,7 @@ namespace ToyConEngine
                                     Vector2 endPos = GetInputPosition(node, i);
                                     if (GetDistanceFromLineSegment(mousePos.ToVector2(), startPos, endPos) < 8f)
                                     {
-                                        input.ConnectedSources.RemoveAt(j);
+                                        _engine.Post(e => { input.ConnectedSources.Remove(source); e.Invalidate(); OnGraphEdited(); });
                                         doubleClickHandled = true;
                                         break;
                                     }
@@ -456,6 +632,7 @@ namespace ToyConEngine
                     if (_isDraggingNodes)
                     {
                         Point delta = mousePos - _lastMousePos;
+                        if (delta != Point.Zero) _autoLayout = false; // the user is arranging by hand now
                         foreach (var node in _selectedNodes)
                         {
                             var r = _nodeRects[node];
@@ -499,57 +676,38 @@ namespace ToyConEngine
 
         protected override void Draw(GameTime gameTime)
         {
+            // Switching render targets discards the back buffer, so previews are rendered before it is cleared
+            if (!_presentationMode) _toyThumbnails.Prepare(GraphicsDevice, _spriteBatch, _pixel, _engine.Nodes.OfType<ToyNode>());
+
             GraphicsDevice.Clear(new Color(30, 30, 30)); // Dark background
 
-            if (_presentationMode)
+            // Screens are uploaded only when the pipeline has a new frame for them
+            if (_outputs.TryTakeFrame(out var frame))
             {
-                GraphicsDevice.Clear(Color.Black);
-                _spriteBatch.Begin(samplerState: SamplerState.PointClamp);
-                
-                var screens = _engine.Nodes.OfType<ScreenNode>().ToList();
-                if (screens.Count > 0)
-                {
-                    // Draw the first screen node scaled to fit
-                    var screen = screens[0];
-                    if (!_screenTextures.ContainsKey(screen)) _screenTextures[screen] = new Texture2D(GraphicsDevice, ScreenNode.Width, ScreenNode.Height);
-                    _screenTextures[screen].SetData(screen.Buffer);
-
-                    int scale = Math.Min(ClientBounds.Width / ScreenNode.Width, ClientBounds.Height / ScreenNode.Height);
-                    int w = ScreenNode.Width * scale;
-                    int h = ScreenNode.Height * scale;
-                    int x = (ClientBounds.Width - w) / 2;
-                    int y = (ClientBounds.Height - h) / 2;
-                    _spriteBatch.Draw(_screenTextures[screen], new Rectangle(x, y, w, h), Color.White);
-                }
-
-                // Draw Buttons and Colors in Presentation Mode
-                foreach (var kvp in _nodeRects)
+                if (_presentationMode) _presentation.Upload(GraphicsDevice, frame);
+                else
                 {
-                    var node = kvp.Key;
-                    var rect = kvp.Value;
-
-                    if (node is ButtonNode btn)
-                    {
-                        Color c = btn.IsPressed ? Color.Gray : Color.DarkGray;
-                        _spriteBatch.Draw(_pixel, rect, c);
-                        DrawHollowRect(_spriteBatch, rect, Color.White, 2);
-                        if (_font != null)
-                        {
-                            Vector2 textSize = _font.MeasureString(btn.Name);
-                            _spriteBatch.DrawString(_font, btn.Name, rect.Center.ToVector2() - textSize / 2, Color.White);
-                        }
-                    }
-                    else if (node is ColorOutputNode col)
+                    foreach (var (screen, pixels) in frame.Screens)
                     {
-                        _spriteBatch.Draw(_pixel, rect, col.DisplayColor);
-                        DrawHollowRect(_spriteBatch, rect, Color.White, 2);
+                        if (!_screenTextures.TryGetValue(screen, out var texture)) _screenTextures[screen] = texture = new Texture2D(GraphicsDevice, ScreenNode.Width, ScreenNode.Height);
+                        texture.SetData(pixels);
                     }
                 }
+                _outputs.ReturnFrame(frame);
+            }
+
+            if (_presentationMode)
+            {
+                _presentation.Compose(GraphicsDevice, _spriteBatch, _pixel, _font);
+                _spriteBatch.Begin(samplerState: SamplerState.PointClamp);
+
+                _presentation.Present(_spriteBatch);
 
                 if (_font != null) 
                 {
                     _spriteBatch.DrawString(_font, _tpsString, new Vector2(10, 10), Color.Lime);
                     DrawTpsGraph(_spriteBatch, new Rectangle(10, 35, 100, 30));
+                    _spriteBatch.DrawString(_font, _pacer.ToString(), new Vector2(10, 70), Color.Lime);
                 }
 
                 _spriteBatch.End();
@@ -595,73 +753,33 @@ namespace ToyConEngine
 
                 // Color code based on type
                 Color color = _selectedNodes.Contains(node) ? Color.Lerp(Color.Gray, Color.White, 0.5f) : Color.Gray;
-                if (node is MathNode) color = Color.RoyalBlue;
+                if (node is MathNode || node is AggregateNode) color = Color.RoyalBlue;
                 if (node is LogicNode) color = Color.Crimson;
                 if (node is ConstantNode) color = Color.ForestGreen;
                 if (node is TimerNode) color = Color.MediumPurple;
                 if (node is CounterNode) color = Color.DarkOrange;
+                if (node is MemoryNode) color = Color.Teal;
+                if (node is DataFileNode dataNode) color = dataNode.IsPending ? Color.DarkCyan : Color.CadetBlue;
                 if (node is ColorOutputNode colorOutput)
                 {
                     color = colorOutput.DisplayColor;
                 }
                 if (node is BeepOutputNode) color = Color.HotPink;
+                if (node is SharedOutputNode) color = Color.SlateBlue;
                 if (node is ScreenNode screenNode)
                 {
                     color = Color.Black;
-                    if (!_screenTextures.ContainsKey(screenNode)) _screenTextures[screenNode] = new Texture2D(GraphicsDevice, ScreenNode.Width, ScreenNode.Height);
-                    _screenTextures[screenNode].SetData(screenNode.Buffer);
-                    // We'll draw the texture after the rect
-                }
-                if (node is ToyNode toyNode)
-                {
-                    var internalScreen = toyNode.GetScreenNode();
-                    if (internalScreen != null)
-                    {
-                        if (!_screenTextures.ContainsKey(internalScreen)) _screenTextures[internalScreen] = new Texture2D(GraphicsDevice, ScreenNode.Width, ScreenNode.Height);
-                        _screenTextures[internalScreen].SetData(internalScreen.Buffer);
-                        // We'll draw the texture after the rect
-                    }
-
-                    // Draw internal graph design
-                    if (toyNode.InternalRects.Count > 0)
-                    {
-                        int minX = int.MaxValue, minY = int.MaxValue, maxX = int.MinValue, maxY = int.MinValue;
-                        foreach(var r in toyNode.InternalRects.Values)
-                        {
-                            if (r.X < minX) minX = r.X;
-                            if (r.Y < minY) minY = r.Y;
-                            if (r.Right > maxX) maxX = r.Right;
-                            if (r.Bottom > maxY) maxY = r.Bottom;
-                        }
-                        
-                        if (maxX > minX && maxY > minY)
-                        {
-                            float graphW = maxX - minX + 100; // padding
-                            float graphH = maxY - minY + 100;
-                            float scale = Math.Min(rect.Width / graphW, rect.Height / graphH);
-                            Vector2 offset = new Vector2(rect.X + rect.Width/2 - (minX + graphW/2 - 50)*scale, rect.Y + rect.Height/2 - (minY + graphH/2 - 50)*scale);
-
-                            foreach(var n in toyNode.InternalEngine.Nodes)
-                            {
-                                if (toyNode.InternalRects.TryGetValue(n, out Rectangle nr))
-                                {
-                                    Rectangle drawRect = new Rectangle(
-                                        (int)(nr.X * scale + offset.X), 
-                                        (int)(nr.Y * scale + offset.Y), 
-                                        (int)(nr.Width * scale), 
-                                        (int)(nr.Height * scale));
-                                    _spriteBatch.Draw(_pixel, drawRect, new Color(100, 100, 100, 100));
-                                }
-                            }
-                        }
-                    }
+                    // The texture is drawn after the rect
                 }
-
                 if (_selectedNodes.Contains(node))
                     color = Color.Lerp(color, Color.White, 0.3f);
 
                 _spriteBatch.Draw(_pixel, rect, color);
 
+                // Miniature of the toy's internal graph, under its screen
+                if (node is ToyNode toyNode && _toyThumbnails.Get(toyNode) is Texture2D thumbnail)
+                    _spriteBatch.Draw(thumbnail, rect, Color.White);
+
                 // Border
                 DrawHollowRect(_spriteBatch, rect, _selectedNodes.Contains(node) ? Color.Yellow : Color.White, _selectedNodes.Contains(node) ? 3 : 1);
 
@@ -722,16 +840,16 @@ namespace ToyConEngine
                 Vector2 sz = _font.MeasureString(_tpsString);
                 _spriteBatch.DrawString(_font, _tpsString, new Vector2(ClientBounds.Width - sz.X - 10, 5), Color.Lime);
                 DrawTpsGraph(_spriteBatch, new Rectangle(ClientBounds.Width - 110, 30, 100, 30));
+                string pace = _pacer.ToString();
+                _spriteBatch.DrawString(_font, pace, new Vector2(ClientBounds.Width - _font.MeasureString(pace).X - 10, 65), Color.Lime);
             }
 
-            if (!string.IsNullOrEmpty(_benchmarkResult))
+            if (_analysisResult != null && _font != null)
             {
-                Vector2 sz = _font?.MeasureString(_benchmarkResult) ?? Vector2.Zero;
-                Vector2 pos = new Vector2((ClientBounds.Width - sz.X) / 2, 50);
-                
-                _spriteBatch.Draw(_pixel, new Rectangle((int)pos.X - 10, (int)pos.Y - 10, (int)sz.X + 20, (int)sz.Y + 20), new Color(0, 0, 0, 200));
-                DrawHollowRect(_spriteBatch, new Rectangle((int)pos.X - 10, (int)pos.Y - 10, (int)sz.X + 20, (int)sz.Y + 20), Color.White);
-                if (_font != null) _spriteBatch.DrawString(_font, _benchmarkResult, pos, Color.White);
+                Vector2 sz = _font.MeasureString(_analysisResult);
+                Vector2 pos = new Vector2(10, ClientBounds.Height - sz.Y - 10);
+                _spriteBatch.Draw(_pixel, new Rectangle((int)pos.X - 5, (int)pos.Y - 5, (int)sz.X + 10, (int)sz.Y + 10), new Color(0, 0, 0, 200));
+                _spriteBatch.DrawString(_font, _analysisResult, pos, Color.White);
             }
 
             DrawOverlay();
@@ -796,7 +914,19 @@ namespace ToyConEngine
                     if (!menuClicked && !_uiBarRect.Contains(mousePos)) _activeMenu = null;
                 }
                 else if (!menuClicked && _activeMenu != null && !_uiBarRect.Contains(mousePos)) _activeMenu = null;
+
+                if (!menuClicked && _workspace.Tabs.Count > 1)
+                {
+                    for (int i = 0; i < _workspace.Tabs.Count; i++)
+                    {
+                        if (!new Rectangle(10 + i * TabWidth, 30, TabWidth, TabHeight).Contains(mousePos)) continue;
+                        if (i != _workspace.ActiveIndex) SwitchTab(i);
+                        captured = true;
+                        break;
+                    }
+                }
             }
+            if (_workspace.Tabs.Count > 1 && new Rectangle(10, 30, _workspace.Tabs.Count * TabWidth, TabHeight).Contains(mousePos)) captured = true;
             return captured;
         }
 
@@ -805,6 +935,19 @@ namespace ToyConEngine
             _spriteBatch.Draw(_pixel, _uiBarRect, new Color(40, 40, 40));
             DrawHollowRect(_spriteBatch, _uiBarRect, Color.Gray);
 
+            if (_workspace.Tabs.Count > 1)
+            {
+                for (int i = 0; i < _workspace.Tabs.Count; i++)
+                {
+                    var tab = _workspace.Tabs[i];
+                    Rectangle tabRect = new Rectangle(10 + i * TabWidth, 30, TabWidth, TabHeight);
+                    bool active = i == _workspace.ActiveIndex;
+                    _spriteBatch.Draw(_pixel, tabRect, active ? new Color(70, 70, 70) : new Color(45, 45, 45));
+                    DrawHollowRect(_spriteBatch, tabRect, active ? Color.White : Color.Gray, 1);
+                    if (_font != null) _spriteBatch.DrawString(_font, $"{tab.Name} {tab.TickRate:F0}Hz P{tab.Priority}", new Vector2(tabRect.X + 5, tabRect.Y + 2), active ? Color.White : Color.LightGray);
+                }
+            }
+
             int x = 10;
             foreach (var category in _menus.Keys)
             {
@@ -859,12 +1002,11 @@ namespace ToyConEngine
 
         private void ParseAndGenerateGraph(string script)
         {
-            _engine.Nodes.Clear();
-            _nodeRects.Clear();
-            _connectionStartNode = null;
+            ClearGraph();
 
             // Tokenize
-            string pattern = @"([(){},;=+\-*/><&|^!]+|\s+|[A-Za-z_][A-Za-z0-9_]*|[0-9.]+)";
+            // One token per punctuation char so "x);" splits into ")" and ";"
+            string pattern = @"([(){},;=+\-*/%><&|^!]|\s+|[A-Za-z_][A-Za-z0-9_]*|[0-9.]+)";
             var tokens = Regex.Split(script, pattern)
                               .Where(t => !string.IsNullOrWhiteSpace(t))
                               .ToList();
@@ -886,6 +1028,9 @@ namespace ToyConEngine
                 ParseBlock(tokens, ref tokenIndex, variables, null, Spawn);
             }
             catch { }
+
+            _autoLayout = true;
+            _engine.Post(e => RequestLayout(false));
         }
 
         private void ParseBlock(List<string> tokens, ref int index, Dictionary<string, Node> variables, Node conditionNode, Action<Node> spawner)
@@ -923,8 +1068,8 @@ namespace ToyConEngine
                     {
                         var andNode = new LogicNode(LogicNode.LogicType.And);
                         spawner(andNode);
-                        _engine.Connect(conditionNode, 0, andNode, 0);
-                        _engine.Connect(cond, 0, andNode, 1);
+                        PostConnect(conditionNode, 0, andNode, 0);
+                        PostConnect(cond, 0, andNode, 1);
                         effectiveCond = andNode;
                     }
 
@@ -961,9 +1106,9 @@ namespace ToyConEngine
                     {
                         var selectNode = new MathNode(MathNode.Operation.Select);
                         spawner(selectNode);
-                        _engine.Connect(conditionNode, 0, selectNode, 0);
-                        _engine.Connect(valNode, 0, selectNode, 1);
-                        _engine.Connect(variables[name], 0, selectNode, 2);
+                        PostConnect(conditionNode, 0, selectNode, 0);
+                        PostConnect(valNode, 0, selectNode, 1);
+                        PostConnect(variables[name], 0, selectNode, 2);
                         variables[name] = selectNode;
                     }
                     else
@@ -994,6 +1139,22 @@ namespace ToyConEngine
             return args;
         }
 
+        // Script functions that map straight onto one fused MathNode
+        private static readonly Dictionary<string, MathNode.Operation> ScriptMathFunctions = new Dictionary<string, MathNode.Operation>
+        {
+            { "abs", MathNode.Operation.Abs },
+            { "min", MathNode.Operation.Min },
+            { "max", MathNode.Operation.Max },
+            { "mod", MathNode.Operation.Modulo },
+            { "sin", MathNode.Operation.Sin },
+            { "cos", MathNode.Operation.Cos },
+            { "floor", MathNode.Operation.Floor },
+            { "clamp", MathNode.Operation.Clamp },
+            { "lerp", MathNode.Operation.Lerp },
+            { "approx", MathNode.Operation.ApproxEqual },
+            { "select", MathNode.Operation.Select }
+        };
+
         private Node ParseExpression(List<string> tokens, ref int index, Dictionary<string, Node> variables, Action<Node> spawner)
         {
             Node left = ParseTerm(tokens, ref index, variables, spawner);
@@ -1001,23 +1162,34 @@ namespace ToyConEngine
             while (index < tokens.Count)
             {
                 string op = tokens[index];
-                if (op == "+" || op == "-" || op == "*" || op == "/" || op == ">" || op == "<")
+                if (op == "+" || op == "*")
+                {
+                    // a + b + c becomes one AggregateNode instead of a chain of MathNodes
+                    var operands = new List<Node> { left };
+                    while (index < tokens.Count && tokens[index] == op)
+                    {
+                        index++;
+                        operands.Add(ParseTerm(tokens, ref index, variables, spawner));
+                    }
+
+                    if (operands.Count == 2)
+                        left = EmitNode(new MathNode(op == "+" ? MathNode.Operation.Add : MathNode.Operation.Multiply), operands, spawner);
+                    else
+                        left = EmitAggregate(op == "+" ? AggregateNode.AggregateType.Sum : AggregateNode.AggregateType.Product, operands, spawner);
+                }
+                else if (op == "-" || op == "/" || op == "%" || op == ">" || op == "<")
                 {
                     index++;
                     Node right = ParseTerm(tokens, ref index, variables, spawner);
 
                     Node opNode = null;
-                    if (op == "+") opNode = new MathNode(MathNode.Operation.Add);
                     if (op == "-") opNode = new MathNode(MathNode.Operation.Subtract);
-                    if (op == "*") opNode = new MathNode(MathNode.Operation.Multiply);
                     if (op == "/") opNode = new MathNode(MathNode.Operation.Divide);
+                    if (op == "%") opNode = new MathNode(MathNode.Operation.Modulo);
                     if (op == ">") opNode = new LogicNode(LogicNode.LogicType.GreaterThan);
                     if (op == "<") opNode = new LogicNode(LogicNode.LogicType.LessThan);
 
-                    spawner(opNode);
-                    _engine.Connect(left, 0, opNode, 0);
-                    _engine.Connect(right, 0, opNode, 1);
-                    left = opNode;
+                    left = EmitNode(opNode, new List<Node> { left, right }, spawner);
                 }
                 else break;
             }
@@ -1034,15 +1206,24 @@ namespace ToyConEngine
                 return c;
             }
             if (variables.ContainsKey(t)) return variables[t];
-            if (t == "abs" && tokens[index] == "(")
+            if (index < tokens.Count && tokens[index] == "(" && IsIdentifier(t))
             {
-                index++;
-                Node arg = ParseExpression(tokens, ref index, variables, spawner);
-                if (tokens[index] == ")") index++;
-                var absNode = new MathNode(MathNode.Operation.Abs);
-                spawner(absNode);
-                _engine.Connect(arg, 0, absNode, 0);
-                return absNode;
+                if (t == "sum" || t == "product" || ((t == "min" || t == "max") && CountArguments(tokens, index) > 2))
+                {
+                    index++;
+                    var args = ParseArguments(tokens, ref index, variables, spawner);
+                    var type = t == "sum" ? AggregateNode.AggregateType.Sum
+                             : t == "product" ? AggregateNode.AggregateType.Product
+                             : t == "min" ? AggregateNode.AggregateType.Min
+                             : AggregateNode.AggregateType.Max;
+                    return EmitAggregate(type, args, spawner);
+                }
+                if (ScriptMathFunctions.TryGetValue(t, out var mathOp))
+                {
+                    index++;
+                    var args = ParseArguments(tokens, ref index, variables, spawner);
+                    return EmitNode(new MathNode(mathOp), args, spawner);
+                }
             }
             if (t == "(")
             {
@@ -1053,6 +1234,38 @@ namespace ToyConEngine
             return new ConstantNode(0);
         }
 
+        // Number of top-level arguments in a call, index points at its "("
+        private int CountArguments(List<string> tokens, int index)
+        {
+            int depth = 0, count = 1;
+            for (int i = index; i < tokens.Count; i++)
+            {
+                if (tokens[i] == "(") depth++;
+                else if (tokens[i] == ")") { if (--depth == 0) return i == index + 1 ? 0 : count; }
+                else if (tokens[i] == "," && depth == 1) count++;
+            }
+            return count;
+        }
+
+        private Node EmitNode(Node node, List<Node> args, Action<Node> spawner)
+        {
+            spawner(node);
+            for (int i = 0; i < args.Count && i < node.Inputs.Count; i++) PostConnect(args[i], 0, node, i);
+            return node;
+        }
+
+        private Node EmitAggregate(AggregateNode.AggregateType type, List<Node> args, Action<Node> spawner)
+        {
+            // More operands than one node takes: reduce in chunks, the partial results feed the next node
+            while (args.Count > AggregateNode.MaxInputs)
+            {
+                var chunk = args.GetRange(0, AggregateNode.MaxInputs);
+                args.RemoveRange(0, AggregateNode.MaxInputs);
+                args.Insert(0, EmitNode(new AggregateNode(type, chunk.Count), chunk, spawner));
+            }
+            return EmitNode(new AggregateNode(type, args.Count), args, spawner);
+        }
+
         private void CreateNode(string name, List<Node> args, Node condition, Action<Node> spawner)
         {
             Node n = null;
@@ -1061,19 +1274,19 @@ namespace ToyConEngine
                 var b = new BeepOutputNode();
                 n = b;
                 spawner(n);
-                if (condition != null) _engine.Connect(condition, 0, n, 0);
-                else { var c = new ConstantNode(1); spawner(c); _engine.Connect(c, 0, n, 0); }
-                if (args.Count > 0) _engine.Connect(args[0], 0, n, 1);
-                if (args.Count > 1) _engine.Connect(args[1], 0, n, 2);
+                if (condition != null) PostConnect(condition, 0, n, 0);
+                else { var c = new ConstantNode(1); spawner(c); PostConnect(c, 0, n, 0); }
+                if (args.Count > 0) PostConnect(args[0], 0, n, 1);
+                if (args.Count > 1) PostConnect(args[1], 0, n, 2);
             }
             else if (name == "ColorNode")
             {
                 var c = new ColorOutputNode();
                 n = c;
                 spawner(n);
-                if (args.Count > 0) _engine.Connect(args[0], 0, n, 0);
-                if (args.Count > 1) _engine.Connect(args[1], 0, n, 1);
-                if (args.Count > 2) _engine.Connect(args[2], 0, n, 2);
+                if (args.Count > 0) PostConnect(args[0], 0, n, 0);
+                if (args.Count > 1) PostConnect(args[1], 0, n, 1);
+                if (args.Count > 2) PostConnect(args[2], 0, n, 2);
             }
         }
 
@@ -1111,17 +1324,33 @@ namespace ToyConEngine
 
                 if (clicked && minusRect.Contains(mousePos))
                 {
-                    foreach (var n in _selectedNodes.OfType<ConstantNode>()) n.StoredValue -= 0.1f;
-                    _inputValueBuffer = cNode.StoredValue.ToString();
+                    var targets = _selectedNodes.OfType<ConstantNode>().ToList();
+                    _engine.Post(e =>
+                    {
+                        foreach (var n in targets) { n.StoredValue -= 0.1f; e.ConstantChanged(n); }
+                        _inputValueBuffer = cNode.StoredValue.ToString();
+                    });
                 }
                 if (clicked && plusRect.Contains(mousePos))
                 {
-                    foreach (var n in _selectedNodes.OfType<ConstantNode>()) n.StoredValue += 0.1f;
-                    _inputValueBuffer = cNode.StoredValue.ToString();
+                    var targets = _selectedNodes.OfType<ConstantNode>().ToList();
+                    _engine.Post(e =>
+                    {
+                        foreach (var n in targets) { n.StoredValue += 0.1f; e.ConstantChanged(n); }
+                        _inputValueBuffer = cNode.StoredValue.ToString();
+                    });
                 }
 
                 HandleTextInput(keyboard, ref _inputValueBuffer);
-                if (float.TryParse(_inputValueBuffer, out float val)) foreach (var n in _selectedNodes.OfType<ConstantNode>()) n.StoredValue = val;
+                if (float.TryParse(_inputValueBuffer, out float val))
+                {
+                    foreach (var n in _selectedNodes.OfType<ConstantNode>())
+                    {
+                        // Applied by the tick at the start of the next frame, before this runs again
+                        if (n.StoredValue == val) continue;
+                        _engine.Post(e => { n.StoredValue = val; e.ConstantChanged(n); });
+                    }
+                }
             }
             else if (_inspectedNode is MathNode mNode)
             {
@@ -1130,15 +1359,47 @@ namespace ToyConEngine
                 int dir = 0;
                 if (clicked && btnRect.Contains(mousePos)) { change = true; dir = 1; }
                 if (IsKeyPressed(keyboard, Keys.Right)) { change = true; dir = 1; }
-                if (IsKeyPressed(keyboard, Keys.Left)) { change = true; dir = 3; }
+                if (IsKeyPressed(keyboard, Keys.Left)) { change = true; dir = MathNode.OperationCount - 1; }
                 
                 if (change)
                 {
-                    foreach (var n in _selectedNodes.OfType<MathNode>())
+                    var targets = _selectedNodes.OfType<MathNode>().ToList();
+                    _engine.Post(e =>
                     {
-                        n.Op = (MathNode.Operation)(((int)n.Op + dir) % 6); // 6 ops now
-                        n.Name = $"Math ({n.Op})";
-                    }
+                        foreach (var n in targets)
+                        {
+                            n.Op = (MathNode.Operation)(((int)n.Op + dir) % MathNode.OperationCount);
+                            n.Name = $"Math ({n.Op})";
+                        }
+                        e.Invalidate();
+                    });
+                }
+            }
+            else if (_inspectedNode is AggregateNode aNode)
+            {
+                Rectangle btnRect = new Rectangle(x, y, 200, 30);
+                Rectangle minusRect = new Rectangle(x, y + 40, 30, 30);
+                Rectangle plusRect = new Rectangle(x + 100, y + 40, 30, 30);
+                int typeCount = Enum.GetValues<AggregateNode.AggregateType>().Length;
+                int typeStep = 0, countStep = 0;
+
+                if ((clicked && btnRect.Contains(mousePos)) || IsKeyPressed(keyboard, Keys.Right)) typeStep = 1;
+                if (IsKeyPressed(keyboard, Keys.Left)) typeStep = typeCount - 1;
+                if (clicked && minusRect.Contains(mousePos)) countStep = -1;
+                if (clicked && plusRect.Contains(mousePos)) countStep = 1;
+
+                if (typeStep != 0 || countStep != 0)
+                {
+                    var targets = _selectedNodes.OfType<AggregateNode>().ToList();
+                    _engine.Post(e =>
+                    {
+                        foreach (var n in targets)
+                        {
+                            n.Type = (AggregateNode.AggregateType)(((int)n.Type + typeStep) % typeCount);
+                            n.InputCount += countStep;
+                        }
+                        e.Invalidate();
+                    });
                 }
             }
             else if (_inspectedNode is LogicNode lNode)
@@ -1152,11 +1413,17 @@ namespace ToyConEngine
 
                 if (change)
                 {
-                    foreach (var n in _selectedNodes.OfType<LogicNode>())
+                    var targets = _selectedNodes.OfType<LogicNode>().ToList();
+                    _engine.Post(e =>
                     {
-                        n.Type = (LogicNode.LogicType)(((int)n.Type + dir) % 6);
-                        n.Name = $"Logic ({n.Type})";
-                    }
+                        foreach (var n in targets)
+                        {
+                            n.Type = (LogicNode.LogicType)(((int)n.Type + dir) % 6);
+                            n.Name = $"Logic ({n.Type})";
+                        }
+                        // Folded values depend on the gate type
+                        e.Invalidate();
+                    });
                 }
             }
             else if (_inspectedNode is KeyNode kNode)
@@ -1204,6 +1471,55 @@ namespace ToyConEngine
                 HandleTextInput(keyboard, ref _inputValueBuffer);
                 if (float.TryParse(_inputValueBuffer, out float val)) foreach (var n in _selectedNodes.OfType<CounterNode>()) n.Value = val;
             }
+            else if (_inspectedNode is MemoryNode memNode)
+            {
+                Rectangle minusRect = new Rectangle(x, y, 30, 30);
+                Rectangle plusRect = new Rectangle(x + 100, y, 30, 30);
+                Rectangle romRect = new Rectangle(x, y + 40, 200, 30);
+                Rectangle loadRect = new Rectangle(x, y + 80, 120, 30);
+
+                // Sizes step in powers of two, typing sets an exact size
+                if (clicked && minusRect.Contains(mousePos))
+                {
+                    var targets = _selectedNodes.OfType<MemoryNode>().ToList();
+                    _engine.Post(e => { foreach (var n in targets) n.Size /= 2; _inputValueBuffer = memNode.Size.ToString(); });
+                }
+                if (clicked && plusRect.Contains(mousePos))
+                {
+                    var targets = _selectedNodes.OfType<MemoryNode>().ToList();
+                    _engine.Post(e => { foreach (var n in targets) n.Size *= 2; _inputValueBuffer = memNode.Size.ToString(); });
+                }
+                if (clicked && romRect.Contains(mousePos))
+                {
+                    foreach (var n in _selectedNodes.OfType<MemoryNode>()) { n.IsReadOnly = !n.IsReadOnly; n.UpdateName(); }
+                }
+                if (clicked && loadRect.Contains(mousePos))
+                {
+                    string path = PromptForOpenPath("Data or Image|*.bin;*.dat;*.png;*.jpg;*.bmp|All Files|*.*");
+                    if (!string.IsNullOrEmpty(path)) LoadMemoryFile(memNode, path);
+                    _inputValueBuffer = memNode.Size.ToString();
+                }
+
+                HandleTextInput(keyboard, ref _inputValueBuffer);
+                _sizeEditOwner = null;
+                if (int.TryParse(_inputValueBuffer, out int size) && size > 0 && size != memNode.Size)
+                {
+                    _sizeEditOwner = memNode;
+                    _sizeEditNodes = _selectedNodes.OfType<MemoryNode>().ToArray();
+                    _sizeEditEngine = _engine;
+                    _sizeEditValue = size;
+                    if (IsKeyPressed(keyboard, Keys.Enter)) CommitMemorySize();
+                }
+            }
+            else if (_inspectedNode is DataFileNode dataNode)
+            {
+                Rectangle browseRect = new Rectangle(x, y + 40, 120, 30);
+                if (clicked && browseRect.Contains(mousePos))
+                {
+                    string path = PromptForOpenPath("Numbers or Data|*.txt;*.csv;*.bin;*.dat|All Files|*.*");
+                    if (!string.IsNullOrEmpty(path)) foreach (var n in _selectedNodes.OfType<DataFileNode>()) n.FilePath = path;
+                }
+            }
             else if (_inspectedNode is ButtonNode btnNode)
             {
                 Rectangle toggleRect = new Rectangle(x, y, 200, 30);
@@ -1247,8 +1563,16 @@ namespace ToyConEngine
                     string path = PromptForOpenPath("Nintendo Labo ToyCon Garage Design File|*.toy");
                     if (!string.IsNullOrEmpty(path))
                     {
-                        toyNode.FilePath = path;
-                        LoadToyNode(toyNode);
+                        _engine.Post(e =>
+                        {
+                            toyNode.FilePath = path;
+                            DesignLoader.LoadToyNode(toyNode);
+                            // Drop wires from outputs the new design no longer has
+                            foreach (var n in e.Nodes)
+                                foreach (var input in n.Inputs) input.ConnectedSources.RemoveAll(src => src.ParentNode == toyNode && !toyNode.Outputs.Contains(src));
+                            e.Invalidate();
+                            OnGraphEdited();
+                        });
                     }
                 }
             }
@@ -1272,6 +1596,16 @@ namespace ToyConEngine
                 HandleTextInput(keyboard, ref _inputValueBuffer);
                 if (int.TryParse(_inputValueBuffer, out int val)) ton.Index = Math.Clamp(val, 0, 9);
             }
+            else if (_inspectedNode is SharedOutputNode so)
+            {
+                Rectangle minusRect = new Rectangle(x, y, 30, 30);
+                Rectangle plusRect = new Rectangle(x + 100, y, 30, 30);
+                if (clicked && minusRect.Contains(mousePos)) { so.Bank = Math.Max(0, so.Bank - 1); _inputValueBuffer = so.Bank.ToString(); }
+                if (clicked && plusRect.Contains(mousePos)) { so.Bank = Math.Min(SharedOutputNode.BankCount - 1, so.Bank + 1); _inputValueBuffer = so.Bank.ToString(); }
+
+                HandleTextInput(keyboard, ref _inputValueBuffer);
+                if (int.TryParse(_inputValueBuffer, out int val)) so.Bank = Math.Clamp(val, 0, SharedOutputNode.BankCount - 1);
+            }
         }
 
         private void DrawOverlay()
@@ -1305,6 +1639,19 @@ namespace ToyConEngine
                 _spriteBatch.Draw(_pixel, new Rectangle(x, y, 200, 30), Color.Gray);
                 if (_font != null) _spriteBatch.DrawString(_font, "Op: " + mNode.Op.ToString(), new Vector2(x + 10, y + 5), Color.White);
             }
+            else if (_inspectedNode is AggregateNode aNode)
+            {
+                _spriteBatch.Draw(_pixel, new Rectangle(x, y, 200, 30), Color.Gray);
+                _spriteBatch.Draw(_pixel, new Rectangle(x, y + 40, 30, 30), Color.Gray);
+                _spriteBatch.Draw(_pixel, new Rectangle(x + 100, y + 40, 30, 30), Color.Gray);
+                if (_font != null)
+                {
+                    _spriteBatch.DrawString(_font, "Type: " + aNode.Type.ToString(), new Vector2(x + 10, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, "-", new Vector2(x + 10, y + 45), Color.White);
+                    _spriteBatch.DrawString(_font, aNode.InputCount.ToString(), new Vector2(x + 40, y + 45), Color.White);
+                    _spriteBatch.DrawString(_font, "+", new Vector2(x + 110, y + 45), Color.White);
+                }
+            }
             else if (_inspectedNode is LogicNode lNode)
             {
                 _spriteBatch.Draw(_pixel, new Rectangle(x, y, 200, 30), Color.Gray);
@@ -1332,6 +1679,35 @@ namespace ToyConEngine
                     _spriteBatch.DrawString(_font, "+", new Vector2(x + 110, y + 5), Color.White);
                 }
             }
+            else if (_inspectedNode is MemoryNode memNode)
+            {
+                _spriteBatch.Draw(_pixel, new Rectangle(x, y, 30, 30), Color.Gray);
+                _spriteBatch.Draw(_pixel, new Rectangle(x + 100, y, 30, 30), Color.Gray);
+                _spriteBatch.Draw(_pixel, new Rectangle(x, y + 40, 200, 30), memNode.IsReadOnly ? Color.Green : Color.Gray);
+                Rectangle loadRect = new Rectangle(x, y + 80, 120, 30);
+                _spriteBatch.Draw(_pixel, loadRect, Color.Gray);
+                DrawHollowRect(_spriteBatch, loadRect, Color.White);
+                if (_font != null)
+                {
+                    _spriteBatch.DrawString(_font, "-", new Vector2(x + 10, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, _inputValueBuffer, new Vector2(x + 40, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, "+", new Vector2(x + 110, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, "Read Only: " + (memNode.IsReadOnly ? "ON" : "OFF"), new Vector2(x + 10, y + 45), Color.White);
+                    _spriteBatch.DrawString(_font, "Load File", new Vector2(x + 10, y + 85), Color.White);
+                }
+            }
+            else if (_inspectedNode is DataFileNode dataNode)
+            {
+                Rectangle browseRect = new Rectangle(x, y + 40, 120, 30);
+                _spriteBatch.Draw(_pixel, browseRect, Color.Gray);
+                DrawHollowRect(_spriteBatch, browseRect, Color.White);
+                if (_font != null)
+                {
+                    string status = dataNode.IsPending ? "Loading..." : dataNode.LastError ?? $"{dataNode.Data.Length} values";
+                    _spriteBatch.DrawString(_font, status, new Vector2(x, y + 5), dataNode.LastError != null ? Color.OrangeRed : Color.White);
+                    _spriteBatch.DrawString(_font, "Choose File", new Vector2(x + 10, y + 45), Color.White);
+                }
+            }
             else if (_inspectedNode is ButtonNode btnNode)
             {
                 _spriteBatch.Draw(_pixel, new Rectangle(x, y, 200, 30), btnNode.IsToggle ? Color.Green : Color.Gray);
@@ -1378,6 +1754,7 @@ namespace ToyConEngine
                 {
                     string fileName = string.IsNullOrEmpty(toyNode.FilePath) ? "None" : Path.GetFileName(toyNode.FilePath);
                     _spriteBatch.DrawString(_font, $"File: {fileName}", new Vector2(x, y), Color.White);
+                    if (toyNode.LoadError != null) _spriteBatch.DrawString(_font, toyNode.LoadError, new Vector2(x, y + 65), Color.OrangeRed);
                 }
 
                 Rectangle btnRect = new Rectangle(x, y + 30, 120, 30);
@@ -1407,6 +1784,29 @@ namespace ToyConEngine
                     _spriteBatch.DrawString(_font, "+", new Vector2(x + 110, y + 5), Color.White);
                 }
             }
+            else if (_inspectedNode is SharedOutputNode so)
+            {
+                _spriteBatch.Draw(_pixel, new Rectangle(x, y, 30, 30), Color.Gray);
+                _spriteBatch.Draw(_pixel, new Rectangle(x + 100, y, 30, 30), Color.Gray);
+                if (_font != null)
+                {
+                    _spriteBatch.DrawString(_font, "-", new Vector2(x + 10, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, $"Bank {so.Bank}", new Vector2(x + 40, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, "+", new Vector2(x + 110, y + 5), Color.White);
+                    _spriteBatch.DrawString(_font, $"Ports {so.Bank * SharedOutputNode.PortsPerBank}-{so.Bank * SharedOutputNode.PortsPerBank + SharedOutputNode.PortsPerBank - 1}", new Vector2(x, y + 40), Color.White);
+                }
+            }
+        }
+
+        private void CommitMemorySize()
+        {
+            var nodes = _sizeEditNodes;
+            int size = _sizeEditValue;
+            _sizeEditOwner = null;
+            _sizeEditNodes = null;
+            // The engine the nodes belong to, which may no longer be the shown tab
+            _sizeEditEngine.Post(e => { foreach (var n in nodes) n.Size = size; });
+            _sizeEditEngine = null;
         }
 
         private void HandleTextInput(KeyboardState current, ref string buffer)
@@ -1527,20 +1927,27 @@ namespace ToyConEngine
         }
 
 
+        // The node and its rect go together at the next tick boundary (the editor ticks on
+        // this thread), so Draw never sees one without the other
         private void DeleteNode(Node node)
         {
-            _engine.Nodes.Remove(node);
-            _nodeRects.Remove(node);
             if (_inspectedNode == node) _inspectedNode = null;
             _selectedNodes.Remove(node);
 
-            foreach (var n in _engine.Nodes)
+            var rects = _nodeRects;
+            _engine.Post(e =>
             {
-                foreach (var input in n.Inputs)
+                e.RemoveNode(node);
+                rects.Remove(node);
+                foreach (var n in e.Nodes)
                 {
-                    input.ConnectedSources.RemoveAll(s => s.ParentNode == node);
+                    foreach (var input in n.Inputs)
+                    {
+                        input.ConnectedSources.RemoveAll(s => s.ParentNode == node);
+                    }
                 }
-            }
+                e.Invalidate();
+            });
         }
 
         private void DeleteSelectedNodes()
@@ -1552,6 +1959,8 @@ namespace ToyConEngine
                 DeleteNode(node);
             }
             _selectedNodes.Clear();
+            // Posted after the deletions, so the layout sees the graph without them
+            _engine.Post(e => OnGraphEdited());
         }
 
         private Node CloneNode(Node original)
@@ -1560,8 +1969,10 @@ namespace ToyConEngine
             if (original is ConstantNode c) clone = new ConstantNode(c.StoredValue);
             else if (original is MathNode m) clone = new MathNode(m.Op);
             else if (original is LogicNode l) clone = new LogicNode(l.Type);
+            else if (original is AggregateNode a) clone = new AggregateNode(a.Type, a.InputCount);
             else if (original is TimerNode) clone = new TimerNode();
             else if (original is CounterNode cnt) { clone = new CounterNode(); ((CounterNode)clone).Value = cnt.Value; }
+            else if (original is MemoryNode mem) { clone = new MemoryNode(); ((MemoryNode)clone).Deserialize(mem.Serialize()); }
             else if (original is RandomNode) clone = new RandomNode();
             else if (original is ButtonNode b) { clone = new ButtonNode(); ((ButtonNode)clone).IsToggle = b.IsToggle; }
             else if (original is KeyNode k) { clone = new KeyNode(); ((KeyNode)clone).Key = k.Key; ((KeyNode)clone).Name = k.Name; }
@@ -1570,9 +1981,11 @@ namespace ToyConEngine
             else if (original is BeepOutputNode bp) { clone = new BeepOutputNode(); ((BeepOutputNode)clone).SoundName = bp.SoundName; }
             else if (original is ScreenNode) clone = new ScreenNode();
             else if (original is ScriptImporterNode s) { clone = new ScriptImporterNode(); ((ScriptImporterNode)clone).Script = s.Script; }
-            else if (original is ToyNode t) { clone = new ToyNode(); ((ToyNode)clone).FilePath = t.FilePath; LoadToyNode((ToyNode)clone); }
+            else if (original is DataFileNode df) { clone = new DataFileNode(); ((DataFileNode)clone).FilePath = df.FilePath; }
+            else if (original is ToyNode t) { clone = new ToyNode(); ((ToyNode)clone).FilePath = t.FilePath; DesignLoader.LoadToyNode((ToyNode)clone); }
             else if (original is ToyInputNode tin) { clone = new ToyInputNode(); ((ToyInputNode)clone).Index = tin.Index; }
             else if (original is ToyOutputNode ton) { clone = new ToyOutputNode(); ((ToyOutputNode)clone).Index = ton.Index; }
+            else if (original is SharedOutputNode so) { clone = new SharedOutputNode(); ((SharedOutputNode)clone).Bank = so.Bank; }
             
             if (clone != null)
             {
@@ -1662,7 +2075,6 @@ namespace ToyConEngine
                 {
                     newNodes.Add(newNode);
                     SpawnNodeAt(newNode, mousePos.X + entry.Offset.X, mousePos.Y + entry.Offset.Y);
-                    _selectedNodes.Add(newNode);
                 }
             }
 
@@ -1676,10 +2088,12 @@ namespace ToyConEngine
                     
                     if (conn.TargetInputIdx < target.Inputs.Count && conn.SourceOutputIdx < source.Outputs.Count)
                     {
-                        _engine.Connect(source, conn.SourceOutputIdx, target, conn.TargetInputIdx);
+                        PostConnect(source, conn.SourceOutputIdx, target, conn.TargetInputIdx);
                     }
                 }
             }
+            // Selected once they are in the engine and have rects
+            _engine.Post(e => { _selectedNodes.AddRange(newNodes); OnGraphEdited(); });
 
             // 3. Offset positions slightly to indicate new paste (or follow mouse if we tracked relative positions)
             // For now, SpawnNode puts them at mouse position, but they will all stack.
@@ -1698,25 +2112,160 @@ namespace ToyConEngine
         {
             var mousePos = Mouse.GetState().Position;
             SpawnNodeAt(node, mousePos.X, mousePos.Y);
+            _engine.Post(e => OnGraphEdited());
         }
 
-        private void SpawnNodeAt(Node node, int x, int y)
+        private void RequestLayout(bool incremental)
+        {
+            if (_layoutTask != null)
+            {
+                // One run at a time; the newest request is picked up when the current one lands
+                _layoutPendingIncremental = _layoutPending ? _layoutPendingIncremental && incremental : incremental;
+                _layoutPending = true;
+                return;
+            }
+            _layoutTask = GraphLayout.Capture(_engine, _nodeRects).RunAsync(incremental);
+        }
+
+        private void ApplyLayout()
+        {
+            var task = _layoutTask;
+            _layoutTask = null;
+            _redraw.Invalidate();
+            if (task.Status == TaskStatus.RanToCompletion && _autoLayout)
+            {
+                foreach (var kvp in task.Result)
+                {
+                    // Nodes deleted while the layout was running are skipped
+                    if (!_nodeRects.TryGetValue(kvp.Key, out Rectangle r)) continue;
+                    r.Location = kvp.Value;
+                    _nodeRects[kvp.Key] = r;
+                }
+            }
+
+            if (_layoutPending)
+            {
+                _layoutPending = false;
+                if (_autoLayout) RequestLayout(_layoutPendingIncremental);
+            }
+        }
+
+        private void SwitchTab(int index)
+        {
+            var current = _workspace.Active;
+            current.Baseline = _baseline;
+            current.AutoLayout = _autoLayout;
+            ShowTab(_workspace.Activate(index));
+        }
+
+        private void CloseTab()
+        {
+            if (_workspace.Tabs.Count == 1) return;
+            _workspace.Close(_workspace.ActiveIndex);
+            ShowTab(_workspace.Activate(_workspace.ActiveIndex));
+        }
+
+        private void ShowTab(DesignTab tab)
+        {
+            // Pending edits belong to the tab being left; background tabs tick on workers
+            _engine.ApplyEdits();
+            if (_sharedOutput != null) { _engine.Ticked -= _sharedOutput.Publish; tab.Engine.Ticked += _sharedOutput.Publish; }
+            if (_injector != null) { _engine.Ticking -= _injector.Apply; tab.Engine.Ticking += _injector.Apply; }
+            if (_recorder != null) { _engine.Ticked -= _recorder.OnTick; tab.Engine.Ticked += _recorder.OnTick; }
+            _engine.Ticked -= _outputs.Publish;
+            tab.Engine.Ticked += _outputs.Publish;
+            _engine = tab.Engine;
+            _editsFailedSeen = _engine.EditsFailed;
+            _nodeRects = tab.Rects;
+            _baseline = tab.Baseline;
+            _autoLayout = tab.AutoLayout;
+            _selectedNodes.Clear(); _inspectedNode = null; _connectionStartNode = null;
+        }
+
+        private void ToggleSharedOutput()
+        {
+            if (_sharedOutput != null)
+            {
+                _engine.Ticked -= _sharedOutput.Publish;
+                _sharedOutput.Dispose();
+                _sharedOutput = null;
+                return;
+            }
+            try
+            {
+                _sharedOutput = new SharedOutputChannel(SharedOutputChannel.DefaultPath);
+                _engine.Ticked += _sharedOutput.Publish;
+            }
+            catch { _sharedOutput = null; }
+        }
+
+        private void ToggleInputInjector()
+        {
+            if (_injector != null)
+            {
+                _engine.Ticking -= _injector.Apply;
+                _injector.Dispose();
+                _injector = null;
+                return;
+            }
+            try
+            {
+                _injector = new InputInjector(InputInjector.DefaultPath);
+                _engine.Ticking += _injector.Apply;
+            }
+            catch { _injector = null; }
+        }
+
+        private void ToggleRecording()
         {
-            _engine.Nodes.Add(node);
-            int width = 100;
-            int height = 60;
-            if (node.Inputs.Count + node.Outputs.Count > 2)
+            if (_recorder != null)
             {
-                width = 120;
-                height = 80;
+                _engine.Ticked -= _recorder.OnTick;
+                // Flushing the queue can take a moment; keep it off the UI thread
+                var recorder = _recorder;
+                _recorder = null;
+                Task.Run(recorder.Dispose);
+                return;
             }
-            if (node is ScreenNode)
+            try
             {
-                width = 140;
-                height = 140;
+                string path = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, $"recording_{DateTime.Now:yyyyMMdd_HHmmss}.y4m");
+                _recorder = new FrameExporter(path);
+                _engine.Ticked += _recorder.OnTick;
             }
-            if (node is ToyNode) { width = 160; height = 240; }
-            _nodeRects[node] = new Rectangle(x, y, width, height);
+            catch { _recorder = null; }
+        }
+
+        // Selects the dead nodes so they can be reviewed and deleted in one go
+        private void AnalyzeGraph()
+        {
+            var analysis = GraphAnalyzer.Analyze(_engine.Nodes);
+            _selectedNodes.Clear();
+            _selectedNodes.AddRange(analysis.Dead.Where(_nodeRects.ContainsKey));
+            _analysisResult = analysis.ToString() + (analysis.Dead.Count > 0 ? "\nDead nodes selected" : "");
+        }
+
+        private void OnGraphEdited()
+        {
+            if (_autoLayout) RequestLayout(true);
+        }
+
+        // Node and rect appear together at the next tick boundary, like every other edit
+        private void SpawnNodeAt(Node node, int x, int y)
+        {
+            var rects = _nodeRects;
+            var rect = DesignLoader.DefaultNodeRect(node, x, y);
+            _engine.Post(e => { e.AddNode(node); rects[node] = rect; });
+        }
+
+        private void PostConnect(Node source, int sourceSlot, Node target, int targetSlot) =>
+            _engine.Post(e => e.Connect(source, sourceSlot, target, targetSlot));
+
+        private void ClearGraph()
+        {
+            var rects = _nodeRects;
+            _engine.Post(e => { e.Clear(); rects.Clear(); });
+            _selectedNodes.Clear(); _inspectedNode = null; _connectionStartNode = null;
         }
 
         private Vector2 GetInputPosition(Node node, int slotIndex)
@@ -1784,132 +2333,125 @@ namespace ToyConEngine
             sb.Draw(_pixel, new Rectangle(rect.X + rect.Width - t, rect.Y, t, rect.Height), color); // Right
         }
 
-        private string SerializeGraph()
+        // Changes whenever something Draw shows from the graph changes: values as printed on
+        // wires and node labels, color swatches, button and loading states. The FPS/TPS readout
+        // is left out: it changes every second, and only refreshes the picture (see Update).
+        private long VisibleSignature()
         {
-            var sb = new StringBuilder();
-            sb.AppendLine("TOYCON_v1");
-            
-            // Map nodes to IDs
-            var nodeToId = new Dictionary<Node, int>();
-            for (int i = 0; i < _engine.Nodes.Count; i++)
-            {
-                var node = _engine.Nodes[i];
-                nodeToId[node] = i;
-                Rectangle r = _nodeRects[node];
-                string type = node.GetType().Name;
-                string data = GetNodeData(node);
-                sb.AppendLine($"NODE {i} {type} {r.X} {r.Y} {data}");
-            }
-
-            // Save Connections
+            long sig = 17;
             foreach (var node in _engine.Nodes)
             {
-                int targetId = nodeToId[node];
-                for (int i = 0; i < node.Inputs.Count; i++)
-                {
-                    var input = node.Inputs[i];
-                    foreach (var source in input.ConnectedSources)
-                    {
-                        int sourceId = nodeToId[source.ParentNode];
-                        int sourceOutputIdx = source.ParentNode.Outputs.IndexOf(source);
-                        sb.AppendLine($"CONN {sourceId} {sourceOutputIdx} {targetId} {i}");
-                    }
-                }
+                if (node is ColorOutputNode col) sig = sig * 31 + col.DisplayColor.GetHashCode();
+                else if (node is ButtonNode btn) sig = sig * 31 + (btn.IsPressed ? 1 : 0);
+                else if (node is DataFileNode data) sig = sig * 31 + (data.IsPending ? 1 : 0);
+                if (_presentationMode) continue;
+                foreach (var output in node.Outputs) sig = sig * 31 + MathF.Round(output.Value, 2).GetHashCode();
             }
+            return sig;
+        }
 
-            return sb.ToString();
+        private GraphSnapshot CaptureSnapshot() => GraphSnapshot.Capture(_engine, _nodeRects, DesignLoader.GetNodeData, _workspace.Active.Layout);
+
+        private void SaveLayout(string filename, DesignCompression compression = DesignCompression.None)
+        {
+            if (string.IsNullOrEmpty(filename)) return;
+            var snapshot = CaptureSnapshot();
+            DesignFile.Save(Path.Combine(AppDomain.CurrentDomain.BaseDirectory, filename), snapshot, compression);
+            _baseline = snapshot;
         }
 
-        private void SaveLayout(string filename)
+        // A patch holds only what changed since the last save, load or patch, keyed by node ID
+        private void SavePatch(string filename)
         {
-            File.WriteAllText(Path.Combine(AppDomain.CurrentDomain.BaseDirectory, filename), SerializeGraph());
+            if (string.IsNullOrEmpty(filename)) return;
+            var snapshot = CaptureSnapshot();
+            var delta = GraphDelta.Compute(_baseline ?? GraphSnapshot.Empty, snapshot);
+
+            string path = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, filename);
+            using (var stream = File.Create(path)) delta.Write(stream);
+            _baseline = snapshot;
         }
 
-        private void LoadGraph(GraphEngine engine, string[] lines, Dictionary<Node, Rectangle> rects = null)
+        private void ApplyPatch(string filename)
         {
-            engine.Nodes.Clear();
-            rects?.Clear();
-            
-            // Clear selection/inspection if we are loading the main graph
-            if (engine == _engine) { _selectedNodes.Clear(); _inspectedNode = null; _connectionStartNode = null; }
-
-            if (lines.Length == 0 || lines[0] != "TOYCON_v1") return;
-
-            var idToNode = new Dictionary<int, Node>();
-
-            foreach (var line in lines)
-            {
-                var parts = line.Split(' ');
-                if (parts[0] == "NODE")
-                {
-                    int id = int.Parse(parts[1]);
-                    string type = parts[2];
-                    int x = int.Parse(parts[3]);
-                    int y = int.Parse(parts[4]);
-                    string data = parts.Length > 5 ? string.Join(" ", parts.Skip(5)) : "";
-
-                    Node n = null;
-                    if (type == "ConstantNode") n = new ConstantNode(0);
-                    else if (type == "MathNode") n = new MathNode(MathNode.Operation.Add);
-                    else if (type == "LogicNode") n = new LogicNode(LogicNode.LogicType.And);
-                    else if (type == "TimerNode") n = new TimerNode();
-                    else if (type == "CounterNode") n = new CounterNode();
-                    else if (type == "RandomNode") n = new RandomNode();
-                    else if (type == "ButtonNode") n = new ButtonNode();
-                    else if (type == "KeyNode") n = new KeyNode();
-                    else if (type == "CursorNode") n = new CursorNode();
-                    else if (type == "ColorOutputNode") n = new ColorOutputNode();
-                    else if (type == "BeepOutputNode") n = new BeepOutputNode();
-                    else if (type == "ScreenNode") n = new ScreenNode();
-                    else if (type == "ScriptImporterNode") n = new ScriptImporterNode();
-                    else if (type == "ToyNode") n = new ToyNode();
-                    else if (type == "ToyInputNode") n = new ToyInputNode();
-                    else if (type == "ToyOutputNode") n = new ToyOutputNode();
-
-                    if (n != null)
-                    {
-                        ApplyNodeData(n, data);
-                        engine.Nodes.Add(n);
-                        if (rects != null)
-                        {
-                            int width = 100;
-                            int height = 60;
-                            if (n.Inputs.Count + n.Outputs.Count > 2) { width = 120; height = 80; }
-                            if (n is ScreenNode) { width = 140; height = 140; }
-                            if (n is ToyNode) { width = 160; height = 240; }
-                            rects[n] = new Rectangle(x, y, width, height);
-                        }
-                        idToNode[id] = n;
-                    }
-                }
-                else if (parts[0] == "CONN")
-                {
-                    int srcId = int.Parse(parts[1]);
-                    int srcSlot = int.Parse(parts[2]);
-                    int tgtId = int.Parse(parts[3]);
-                    int tgtSlot = int.Parse(parts[4]);
+            if (string.IsNullOrEmpty(filename)) return;
+            string path = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, filename);
+            if (!File.Exists(path)) return;
 
-                    if (idToNode.ContainsKey(srcId) && idToNode.ContainsKey(tgtId))
-                    {
-                        engine.Connect(idToNode[srcId], srcSlot, idToNode[tgtId], tgtSlot);
-                    }
-                }
+            GraphDelta delta;
+            try
+            {
+                using (var stream = File.OpenRead(path)) delta = GraphDelta.Read(stream);
+            }
+            catch (Exception ex) when (ex is InvalidDataException || ex is EndOfStreamException || ex is IOException)
+            {
+                _analysisResult = $"{Path.GetFileName(path)} is not a readable patch ({ex.Message}); not applied.";
+                return;
+            }
+
+            // A patch made against a different version of the design would wire the wrong nodes
+            _engine.ApplyEdits();
+            if (!delta.Fits(CaptureSnapshot()))
+            {
+                _analysisResult = $"{Path.GetFileName(path)} was made from a different version of this design; not applied.";
+                return;
+            }
+
+            _selectedNodes.Clear(); _inspectedNode = null; _connectionStartNode = null;
+            try
+            {
+                delta.ApplyTo(_engine, _nodeRects, r =>
+                {
+                    var n = DesignLoader.CreateNodeOfType(r.Type);
+                    if (n != null) _nodeRects[n] = DesignLoader.DefaultNodeRect(n, r.X, r.Y);
+                    return n;
+                }, DesignLoader.ApplyNodeData);
             }
+            catch (InvalidDataException ex)
+            {
+                _analysisResult = $"{ex.Message}; not applied.";
+                return;
+            }
+            _baseline = CaptureSnapshot();
+            OnGraphEdited();
+        }
+
+        private void LoadGraph(GraphEngine engine, IEnumerable<string> lines, Dictionary<Node, Rectangle> rects = null)
+        {
+            // Clear selection/inspection if we are loading the main graph
+            if (engine == _engine) { _engine.ApplyEdits(); _selectedNodes.Clear(); _inspectedNode = null; _connectionStartNode = null; _autoLayout = false; }
+
+            DesignLoader.Load(engine, lines, rects, engine == _engine ? _workspace.Active.Layout : null);
+            if (engine == _engine) _baseline = CaptureSnapshot();
         }
 
         private void LoadLayout(string filename)
         {
+            if (string.IsNullOrEmpty(filename)) return;
             string path = Path.Combine(AppDomain.CurrentDomain.BaseDirectory, filename);
             if (!File.Exists(path)) return;
-            LoadGraph(_engine, File.ReadAllLines(path), _nodeRects);
+            LoadGraph(_engine, DesignFile.ReadLines(path), _nodeRects);
         }
 
-        private void LoadToyNode(ToyNode node)
+        private void LoadMemoryFile(MemoryNode node, string path)
         {
-            if (string.IsNullOrEmpty(node.FilePath) || !File.Exists(node.FilePath)) return;
-            string[] lines = File.ReadAllLines(node.FilePath);
-            LoadGraph(node.InternalEngine, lines, node.InternalRects);
-            node.RefreshPorts();
+            try
+            {
+                string ext = Path.GetExtension(path).ToLowerInvariant();
+                if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp")
+                {
+                    using var stream = File.OpenRead(path);
+                    using var texture = Texture2D.FromStream(GraphicsDevice, stream);
+                    var pixels = new Color[texture.Width * texture.Height];
+                    texture.GetData(pixels);
+                    node.LoadPixels(pixels);
+                }
+                else
+                {
+                    node.LoadBytes(File.ReadAllBytes(path));
+                }
+            }
+            catch { }
         }
 
         private void ExportStandalone(string filename)
@@ -1934,9 +2476,10 @@ namespace ToyConEngine
                 CopyDirectory(sourceDir, tempDir);
                 File.Copy(currentExe, exportPath, true);
 
-                // 2. Prepare data
-                string graphData = SerializeGraph();
-                byte[] dataBytes = Encoding.UTF8.GetBytes(graphData);
+                // 2. Prepare data (compressed, TryLoadEmbeddedLayout sniffs the header)
+                var graphData = new MemoryStream();
+                DesignFile.Write(graphData, CaptureSnapshot().WriteTo, DesignCompression.Brotli);
+                byte[] dataBytes = graphData.ToArray();
                 byte[] lengthBytes = BitConverter.GetBytes(dataBytes.Length);
                 byte[] magicBytes = Encoding.UTF8.GetBytes(StandaloneMagic); // 10 bytes
 
@@ -2047,47 +2590,11 @@ namespace ToyConEngine
                     stream.Seek(-(14 + dataLength), SeekOrigin.End);
                     stream.Read(data, 0, dataLength);
 
-                    string layout = Encoding.UTF8.GetString(data);
-                    // Split by newline, handling both \r\n and \n
-                    LoadGraph(_engine, layout.Split(new[] { "\r\n", "\r", "\n" }, StringSplitOptions.None), _nodeRects);
+                    LoadGraph(_engine, DesignFile.ReadLines(new MemoryStream(data)), _nodeRects);
                     return true;
                 }
             }
             catch { return false; }
         }
-
-        private string GetNodeData(Node node)
-        {
-            if (node is ConstantNode c) return c.StoredValue.ToString();
-            if (node is MathNode m) return m.Op.ToString();
-            if (node is LogicNode l) return l.Type.ToString();
-            if (node is KeyNode k) return k.Key.ToString();
-            if (node is ButtonNode b) return b.IsToggle.ToString();
-            if (node is BeepOutputNode beep) return beep.SoundName;
-            if (node is CounterNode cnt) return cnt.Value.ToString();
-            if (node is ScriptImporterNode s) return Convert.ToBase64String(Encoding.UTF8.GetBytes(s.Script));
-            if (node is ToyNode t) return Convert.ToBase64String(Encoding.UTF8.GetBytes(t.FilePath ?? ""));
-            if (node is ToyInputNode tin) return tin.Index.ToString();
-            if (node is ToyOutputNode ton) return ton.Index.ToString();
-            return "";
-        }
-
-        private void ApplyNodeData(Node node, string data)
-        {
-            if (string.IsNullOrEmpty(data)) return;
-            try {
-                if (node is ConstantNode c) c.StoredValue = float.Parse(data);
-                if (node is MathNode m) { m.Op = Enum.Parse<MathNode.Operation>(data); m.Name = $"Math ({m.Op})"; }
-                if (node is LogicNode l) { l.Type = Enum.Parse<LogicNode.LogicType>(data); l.Name = $"Logic ({l.Type})"; }
-                if (node is KeyNode k) { k.Key = Enum.Parse<Keys>(data); k.Name = $"Key ({k.Key})"; }
-                if (node is ButtonNode b) b.IsToggle = bool.Parse(data);
-                if (node is BeepOutputNode beep) beep.SoundName = data;
-                if (node is CounterNode cnt) cnt.Value = float.Parse(data);
-                if (node is ScriptImporterNode s) s.Script = Encoding.UTF8.GetString(Convert.FromBase64String(data));
-                if (node is ToyNode t) { t.FilePath = Encoding.UTF8.GetString(Convert.FromBase64String(data)); LoadToyNode(t); }
-                if (node is ToyInputNode tin) tin.Index = int.Parse(data);
-                if (node is ToyOutputNode ton) ton.Index = int.Parse(data);
-            } catch {}
-        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // The toy files a design depends on, read once each. Resolve walks the references from a
+    // root file breadth first, reading each wave of new files in parallel, and then marks every
+    // file that can reach itself (a self-reference or part of a reference cycle). Every ToyNode
+    // instance still gets its own internal engine, but they are all built from the lines read
+    // here, so a sub-toy shared by many toys (a diamond) is read and decompressed only once.
+    public sealed class ToyDependencyResolver
+    {
+        private readonly Dictionary<string, string[]> _lines = new Dictionary<string, string[]>(StringComparer.Ordinal);
+        private readonly Dictionary<string, List<string>> _references = new Dictionary<string, List<string>>(StringComparer.Ordinal);
+        private readonly Dictionary<string, string> _errors = new Dictionary<string, string>(StringComparer.Ordinal);
+        private readonly HashSet<string> _cyclic = new HashSet<string>(StringComparer.Ordinal);
+
+        public int FileCount => _lines.Count;
+
+        public static string Normalize(string path) => Path.GetFullPath(path);
+
+        // Reads path and everything it references that has not been read yet
+        public void Resolve(string path)
+        {
+            path = Normalize(path);
+            if (_lines.ContainsKey(path) || _errors.ContainsKey(path)) return;
+
+            var wave = new List<string> { path };
+            while (wave.Count > 0)
+            {
+                var read = new (string[] Lines, List<string> References, string Error)[wave.Count];
+                Parallel.For(0, wave.Count, i => read[i] = Read(wave[i]));
+
+                var next = new HashSet<string>(StringComparer.Ordinal);
+                for (int i = 0; i < wave.Count; i++)
+                {
+                    if (read[i].Error != null) { _errors[wave[i]] = read[i].Error; continue; }
+                    _lines[wave[i]] = read[i].Lines;
+                    _references[wave[i]] = read[i].References;
+                    foreach (var reference in read[i].References)
+                        if (!_lines.ContainsKey(reference) && !_errors.ContainsKey(reference)) next.Add(reference);
+                }
+                wave = next.ToList();
+            }
+            FindCycles();
+        }
+
+        // Lines of a resolved file, or null with the reason it cannot be loaded
+        public string[] GetLines(string path, out string error)
+        {
+            path = Normalize(path);
+            if (_errors.TryGetValue(path, out error)) return null;
+            if (_cyclic.Contains(path)) { error = $"{Path.GetFileName(path)} contains itself"; return null; }
+            if (_lines.TryGetValue(path, out var lines)) return lines;
+            error = $"{Path.GetFileName(path)} was not resolved";
+            return null;
+        }
+
+        private static (string[], List<string>, string) Read(string path)
+        {
+            if (!File.Exists(path)) return (null, null, $"{Path.GetFileName(path)} not found");
+            try
+            {
+                var lines = DesignFile.ReadLines(path).ToArray();
+                var references = new List<string>();
+                foreach (var line in lines)
+                {
+                    if (!line.StartsWith("NODE ")) continue;
+                    var parts = line.Split(' ');
+                    if (parts.Length < 6 || parts[2] != "ToyNode") continue;
+                    string reference = TryDecodePath(parts[5]);
+                    if (!string.IsNullOrEmpty(reference)) references.Add(Normalize(reference));
+                }
+                return (lines, references, null);
+            }
+            catch (Exception ex)
+            {
+                return (null, null, ex.Message);
+            }
+        }
+
+        private static string TryDecodePath(string data)
+        {
+            try { return Encoding.UTF8.GetString(Convert.FromBase64String(data)); }
+            catch (FormatException) { return null; }
+        }
+
+        // Tarjan's strongly connected components over the reference graph, iteratively so a
+        // deep chain of toys cannot overflow the stack either
+        private void FindCycles()
+        {
+            _cyclic.Clear();
+            var index = new Dictionary<string, int>(StringComparer.Ordinal);
+            var low = new Dictionary<string, int>(StringComparer.Ordinal);
+            var onStack = new HashSet<string>(StringComparer.Ordinal);
+            var stack = new Stack<string>();
+            int counter = 0;
+
+            foreach (var root in _references.Keys)
+            {
+                if (index.ContainsKey(root)) continue;
+                var work = new Stack<(string Node, int Next)>();
+                work.Push((root, 0));
+                index[root] = low[root] = counter++;
+                stack.Push(root);
+                onStack.Add(root);
+
+                while (work.Count > 0)
+                {
+                    var (node, next) = work.Pop();
+                    var references = _references[node];
+                    if (next < references.Count)
+                    {
+                        work.Push((node, next + 1));
+                        var target = references[next];
+                        if (!_references.ContainsKey(target)) continue;
+                        if (!index.ContainsKey(target))
+                        {
+                            index[target] = low[target] = counter++;
+                            stack.Push(target);
+                            onStack.Add(target);
+                            work.Push((target, 0));
+                        }
+                        else if (onStack.Contains(target)) low[node] = Math.Min(low[node], index[target]);
+                        continue;
+                    }
+
+                    if (work.Count > 0)
+                    {
+                        var parent = work.Peek().Node;
+                        low[parent] = Math.Min(low[parent], low[node]);
+                    }
+                    if (low[node] != index[node]) continue;
+
+                    var component = new List<string>();
+                    string member;
+                    do
+                    {
+                        member = stack.Pop();
+                        onStack.Remove(member);
+                        component.Add(member);
+                    } while (member != node);
+
+                    if (component.Count > 1 || _references[node].Contains(node))
+                        foreach (var c in component) _cyclic.Add(c);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+using Microsoft.Xna.Framework;
+using Microsoft.Xna.Framework.Graphics;
+using System;
+using System.Collections.Generic;
+
+namespace ToyConEngine
+{
+    // Miniature previews of ToyNode subgraphs, rendered once into a render target per toy
+    // design (file and internal layout) and shared by every instance of it. A preview is
+    // drawn again only when a toy's layout changes (a reload gives it a new LayoutHash) or
+    // the device loses the target; previews no toy used in a frame are released.
+    public sealed class ToyThumbnailCache : IDisposable
+    {
+        public const int Width = 160;
+        public const int Height = 240;
+
+        private sealed class Entry
+        {
+            public RenderTarget2D Target;
+            public bool Used;
+        }
+
+        private readonly Dictionary<(string Path, int Layout), Entry> _entries = new Dictionary<(string, int), Entry>();
+        private readonly List<(string, int)> _unused = new List<(string, int)>();
+
+        public int Count => _entries.Count;
+
+        // Renders the previews missing for these toys; call outside any SpriteBatch.Begin/End
+        public void Prepare(GraphicsDevice device, SpriteBatch sb, Texture2D pixel, IEnumerable<ToyNode> toys)
+        {
+            foreach (var entry in _entries.Values) entry.Used = false;
+
+            bool rendered = false;
+            foreach (var toy in toys)
+            {
+                if (toy.InternalRects.Count == 0) continue;
+                var key = (toy.FilePath ?? "", toy.LayoutHash);
+                if (!_entries.TryGetValue(key, out var entry)) _entries[key] = entry = new Entry();
+                entry.Used = true;
+                if (entry.Target != null && !entry.Target.IsContentLost) continue;
+
+                entry.Target ??= new RenderTarget2D(device, Width, Height);
+                device.SetRenderTarget(entry.Target);
+                device.Clear(Color.Transparent);
+                sb.Begin();
+                Render(sb, pixel, toy.InternalRects);
+                sb.End();
+                rendered = true;
+            }
+            if (rendered) device.SetRenderTarget(null);
+
+            _unused.Clear();
+            foreach (var kv in _entries) if (!kv.Value.Used) _unused.Add(kv.Key);
+            foreach (var key in _unused)
+            {
+                _entries[key].Target?.Dispose();
+                _entries.Remove(key);
+            }
+        }
+
+        public Texture2D Get(ToyNode toy) =>
+            _entries.TryGetValue((toy.FilePath ?? "", toy.LayoutHash), out var entry) ? entry.Target : null;
+
+        // The subgraph's node rects, fitted to the thumbnail with some padding
+        private static void Render(SpriteBatch sb, Texture2D pixel, Dictionary<Node, Rectangle> rects)
+        {
+            int minX = int.MaxValue, minY = int.MaxValue, maxX = int.MinValue, maxY = int.MinValue;
+            foreach (var r in rects.Values)
+            {
+                if (r.X < minX) minX = r.X;
+                if (r.Y < minY) minY = r.Y;
+                if (r.Right > maxX) maxX = r.Right;
+                if (r.Bottom > maxY) maxY = r.Bottom;
+            }
+            if (maxX <= minX || maxY <= minY) return;
+
+            float graphW = maxX - minX + 100;
+            float graphH = maxY - minY + 100;
+            float scale = Math.Min(Width / graphW, Height / graphH);
+            Vector2 offset = new Vector2(Width / 2 - (minX + graphW / 2 - 50) * scale, Height / 2 - (minY + graphH / 2 - 50) * scale);
+
+            foreach (var r in rects.Values)
+            {
+                var drawRect = new Rectangle((int)(r.X * scale + offset.X), (int)(r.Y * scale + offset.Y), (int)(r.Width * scale), (int)(r.Height * scale));
+                sb.Draw(pixel, drawRect, new Color(100, 100, 100, 100));
+            }
+        }
+
+        public void Dispose()
+        {
+            foreach (var entry in _entries.Values) entry.Target?.Dispose();
+            _entries.Clear();
+        }
+    }
+}
@@ -0,0 +1,116 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // Several designs in one process, sharing the graphics device, content and runtime.
+    // The active tab is ticked by the editor on the UI thread; every other tab is ticked
+    // on the shared thread pool at its own rate, highest Priority first.
+    public class Workspace
+    {
+        // Catch-up cap, so a design that fell behind does not monopolise a worker
+        public const int MaxTicksPerRun = 64;
+
+        public List<DesignTab> Tabs { get; } = new List<DesignTab>();
+        public int ActiveIndex { get; private set; }
+        public DesignTab Active => Tabs[ActiveIndex];
+        public int WorkerCount { get; set; } = Math.Max(1, Environment.ProcessorCount - 1);
+
+        private readonly List<DesignTab> _due = new List<DesignTab>();
+
+        public Workspace()
+        {
+            Tabs.Add(new DesignTab("Design 1"));
+        }
+
+        public DesignTab Add(string name)
+        {
+            var tab = new DesignTab(name);
+            Tabs.Add(tab);
+            return tab;
+        }
+
+        // Waits for the tab's background run so the editor never shares an engine with a worker
+        public DesignTab Activate(int index)
+        {
+            var tab = Tabs[index];
+            tab.Running?.Wait();
+            tab.Running = null;
+            tab.Due = 0;
+            ActiveIndex = index;
+            return tab;
+        }
+
+        public void Close(int index)
+        {
+            if (Tabs.Count == 1) return;
+            Tabs[index].Running?.Wait();
+            Tabs.RemoveAt(index);
+            if (ActiveIndex >= index && ActiveIndex > 0) ActiveIndex--;
+        }
+
+        // Called once per frame from the UI thread. Due designs are queued highest Priority
+        // first and drained by up to WorkerCount pool tasks; a design whose previous run has
+        // not finished keeps accumulating ticks (up to MaxTicksPerRun) instead of overlapping.
+        public void RunBackground(double elapsedSeconds)
+        {
+            _due.Clear();
+            for (int i = 0; i < Tabs.Count; i++)
+            {
+                if (i == ActiveIndex) continue;
+                var tab = Tabs[i];
+                // Nobody is looking at a background design's unused nodes
+                tab.Engine.PruneDeadNodes = true;
+                tab.Due = Math.Min(tab.Due + elapsedSeconds * tab.TickRate, MaxTicksPerRun);
+                if (tab.Running != null)
+                {
+                    if (!tab.Running.IsCompleted) continue;
+                    tab.Running = null;
+                }
+                if (tab.Due >= 1) _due.Add(tab);
+            }
+            if (_due.Count == 0) return;
+
+            _due.Sort((a, b) => b.Priority.CompareTo(a.Priority));
+            var queue = _due.ToArray();
+            var ticks = new int[queue.Length];
+            for (int i = 0; i < queue.Length; i++)
+            {
+                ticks[i] = (int)queue[i].Due;
+                queue[i].Due -= ticks[i];
+            }
+
+            int next = -1;
+            var workers = new Task[Math.Min(WorkerCount, queue.Length)];
+            for (int w = 0; w < workers.Length; w++)
+            {
+                workers[w] = Task.Run(() =>
+                {
+                    int i;
+                    while ((i = Interlocked.Increment(ref next)) < queue.Length) Run(queue[i], ticks[i]);
+                });
+            }
+
+            var all = workers.Length == 1 ? workers[0] : Task.WhenAll(workers);
+            foreach (var tab in queue) tab.Running = all;
+        }
+
+        private static void Run(DesignTab tab, int ticks)
+        {
+            var step = TimeSpan.FromSeconds(1.0 / tab.TickRate);
+            for (int t = 0; t < ticks; t++)
+            {
+                tab.Engine.Tick(new GameTime(TimeSpan.FromTicks(step.Ticks * tab.TotalTicks), step));
+                tab.TotalTicks++;
+            }
+        }
+
+        public void WaitAll()
+        {
+            foreach (var tab in Tabs) tab.Running?.Wait();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // Base for nodes whose work can take longer than a tick (file reads, sample loading,
+    // external data). Evaluate calls Start; the operation runs on the thread pool while the
+    // node keeps its last outputs, and its result is handed to Completed on the tick thread
+    // at the start of a later tick of the engine that started it (GraphEngine drains the
+    // completions before evaluating), so the tick never waits for it.
+    public abstract class AsyncNode : Node
+    {
+        public bool IsPending => Volatile.Read(ref _pending) != 0;
+        public string LastError { get; private set; }
+
+        private int _pending;
+        private CancellationTokenSource _cancel = new CancellationTokenSource();
+        private float[] _result;
+        private Exception _error;
+
+        // Returns false when an operation is already running or no engine is ticking
+        protected bool Start(Func<CancellationToken, ValueTask<float[]>> operation)
+        {
+            var engine = GraphEngine.Current;
+            if (engine == null || Interlocked.CompareExchange(ref _pending, 1, 0) != 0) return false;
+
+            var token = _cancel.Token;
+            engine.AsyncStarted();
+            // Even the synchronous part of the operation runs off the tick thread
+            Task.Run(async () =>
+            {
+                try
+                {
+                    _result = await operation(token).ConfigureAwait(false);
+                    token.ThrowIfCancellationRequested();
+                }
+                catch (Exception e) { _error = e; }
+                engine.PostCompletion(this);
+            });
+            return true;
+        }
+
+        // Tick thread, called by GraphEngine
+        internal void Publish()
+        {
+            var result = _result;
+            var error = _error;
+            _result = null;
+            _error = null;
+            Volatile.Write(ref _pending, 0);
+
+            if (error is OperationCanceledException) return;
+            LastError = error?.Message;
+            if (error == null) Completed(result);
+        }
+
+        // Runs on the tick thread with the operation's result
+        protected abstract void Completed(float[] result);
+
+        // Abandons the running operation; its result is dropped
+        public void Cancel()
+        {
+            _cancel.Cancel();
+            _cancel = new CancellationTokenSource();
+        }
+    }
+}
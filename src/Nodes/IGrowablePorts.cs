@@ -0,0 +1,10 @@
+namespace ToyConEngine
+{
+    // Nodes whose port count depends on their settings or on another file. A design may hold
+    // wires to ports such a node does not currently have (an input an Op no longer reads, a
+    // toy whose file is missing); the loader asks for those ports instead of dropping the wires.
+    public interface IGrowablePorts
+    {
+        void EnsurePorts(int inputs, int outputs);
+    }
+}
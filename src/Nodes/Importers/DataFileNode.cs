@@ -0,0 +1,82 @@
+using Microsoft.Xna.Framework;
+using System;
+using System.Globalization;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace ToyConEngine
+{
+    // Table of numbers read from a file in the background (see AsyncNode). Text files hold
+    // numbers separated by whitespace, commas or semicolons; any other file is read as bytes
+    // (0-255). The file is (re)read when the path changes or Load rises; until then the
+    // previous table stays in place, and Ready is 0 while a read is running.
+    public class DataFileNode : AsyncNode
+    {
+        private static readonly char[] Separators = { ' ', '\t', '\r', '\n', ',', ';' };
+
+        public string FilePath
+        {
+            get => _filePath;
+            set { if (_filePath != value) { _filePath = value; _stale = true; UpdateName(); } }
+        }
+        public float[] Data { get; private set; } = new float[0];
+
+        private string _filePath = "";
+        private bool _stale;
+        private bool _prevLoad;
+
+        public DataFileNode()
+        {
+            UpdateName();
+            AddInput("Index");
+            AddInput("Load");
+            AddOutput("Value");
+            AddOutput("Count");
+            AddOutput("Ready");
+        }
+
+        public override void Evaluate(GameTime gameTime)
+        {
+            bool load = Inputs[1].GetValue() > 0;
+            if ((_stale || (load && !_prevLoad)) && _filePath.Length > 0)
+            {
+                string path = _filePath;
+                if (Start(token => ReadAsync(path, token))) _stale = false;
+            }
+            _prevLoad = load;
+
+            int index = (int)MathF.Floor(Inputs[0].GetValue());
+            var data = Data;
+            Outputs[0].SetValue(index >= 0 && index < data.Length ? data[index] : 0f);
+            Outputs[1].SetValue(data.Length);
+            Outputs[2].SetValue(IsPending ? 0f : 1f);
+        }
+
+        protected override void Completed(float[] result) => Data = result;
+
+        public void UpdateName() => Name = _filePath.Length > 0 ? $"Data ({Path.GetFileName(_filePath)})" : "Data";
+
+        private static async ValueTask<float[]> ReadAsync(string path, CancellationToken token)
+        {
+            byte[] bytes = await File.ReadAllBytesAsync(path, token).ConfigureAwait(false);
+            int limit = Math.Min(bytes.Length, MemoryNode.MaxSize);
+
+            string ext = Path.GetExtension(path).ToLowerInvariant();
+            if (ext != ".txt" && ext != ".csv")
+            {
+                var raw = new float[limit];
+                for (int i = 0; i < limit; i++) raw[i] = bytes[i];
+                return raw;
+            }
+
+            var fields = System.Text.Encoding.UTF8.GetString(bytes).Split(Separators, StringSplitOptions.RemoveEmptyEntries);
+            var values = new float[Math.Min(fields.Length, MemoryNode.MaxSize)];
+            for (int i = 0; i < values.Length; i++)
+            {
+                float.TryParse(fields[i], NumberStyles.Float, CultureInfo.InvariantCulture, out values[i]);
+            }
+            return values;
+        }
+    }
+}
@@ -2,17 +2,36 @@
 
 using Microsoft.Xna.Framework;
 using Microsoft.Xna.Framework.Graphics;
+using System;
 using System.Collections.Generic;
 using System.Linq;
 
 namespace ToyConEngine
 {
-    public class ToyNode : Node
+    public class ToyNode : Node, IGrowablePorts
     {
+        // ToyInputNode/ToyOutputNode indices run 0-9
+        public const int MaxPorts = 10;
+
         public string FilePath { get; set; }
         public GraphEngine InternalEngine { get; private set; } = new GraphEngine();
         public Dictionary<Node, Rectangle> InternalRects { get; } = new Dictionary<Node, Rectangle>();
+        // Why the design could not be loaded (see DesignLoader.LoadToyNode), or null
+        public string LoadError { get; set; }
+        // Identifies the internal layout, so toys loaded from the same design share one preview
+        public int LayoutHash { get; private set; }
         
+        // Boundary transfer, compiled from the internal ToyInput/ToyOutput nodes whenever the
+        // internal plan changes: input sums are gathered into one slot per port, then scattered
+        // to every ToyInputNode reading that slot; after the internal tick each ToyOutputNode's
+        // sum is written to its port.
+        private ExecutionPlan _boundaryPlan;
+        private float[] _inputValues = new float[0];
+        private int[] _inputSlots = new int[0];
+        private OutputPort[] _inputTargets = new OutputPort[0];
+        private int[] _outputSlots = new int[0];
+        private InputPort[] _outputSources = new InputPort[0];
+
         public ToyNode()
         {
             Name = "Toy Project";
@@ -23,45 +42,81 @@ namespace ToyConEngine
 
         public override void Evaluate(GameTime gameTime)
         {
-            // Map Inputs to Internal ToyInputNodes
-            foreach (var inputNode in InternalEngine.Nodes.OfType<ToyInputNode>())
-            {
-                if (inputNode.Index < Inputs.Count)
-                {
-                    float val = 0f;
-                    foreach (var source in Inputs[inputNode.Index].ConnectedSources)
-                        val += source.Value;
-                    
-                    if (inputNode.Outputs.Count > 0)
-                        inputNode.Outputs[0].Value = val;
-                }
-            }
+            if (_boundaryPlan != InternalEngine.Plan) CompileBoundary();
+
+            var values = _inputValues;
+            for (int i = 0; i < values.Length; i++) values[i] = Sum(Inputs[i].ConnectedSources);
+            for (int k = 0; k < _inputTargets.Length; k++) _inputTargets[k].SetValue(values[_inputSlots[k]]);
 
             InternalEngine.Tick(gameTime);
 
-            // Map Internal ToyOutputNodes to Outputs
-            foreach (var outputNode in InternalEngine.Nodes.OfType<ToyOutputNode>())
+            for (int k = 0; k < _outputSources.Length; k++) Outputs[_outputSlots[k]].SetValue(Sum(_outputSources[k].ConnectedSources));
+        }
+
+        private static float Sum(List<OutputPort> sources)
+        {
+            float sum = 0f;
+            for (int i = 0; i < sources.Count; i++) sum += sources[i].Value;
+            return sum;
+        }
+
+        private void CompileBoundary()
+        {
+            _boundaryPlan = InternalEngine.Plan;
+            var inputSlots = new List<int>();
+            var inputTargets = new List<OutputPort>();
+            var outputSlots = new List<int>();
+            var outputSources = new List<InputPort>();
+            foreach (var node in InternalEngine.Nodes)
             {
-                if (outputNode.Index < Outputs.Count)
-                {
-                    float val = 0f;
-                    if (outputNode.Inputs.Count > 0)
-                    {
-                        foreach (var source in outputNode.Inputs[0].ConnectedSources)
-                            val += source.Value;
-                    }
-                    Outputs[outputNode.Index].Value = val;
-                }
+                if (node is ToyInputNode tin && tin.Index >= 0 && tin.Index < Inputs.Count) { inputSlots.Add(tin.Index); inputTargets.Add(tin.Outputs[0]); }
+                else if (node is ToyOutputNode ton && ton.Index >= 0 && ton.Index < Outputs.Count) { outputSlots.Add(ton.Index); outputSources.Add(ton.Inputs[0]); }
             }
+            _inputValues = new float[Inputs.Count];
+            _inputSlots = inputSlots.ToArray();
+            _inputTargets = inputTargets.ToArray();
+            _outputSlots = outputSlots.ToArray();
+            _outputSources = outputSources.ToArray();
         }
-        
+
+        // One port per index up to the highest ToyInputNode/ToyOutputNode index inside.
+        // Existing ports are kept so their wires survive a reload, and while the design
+        // cannot be read (LoadError) none are removed, so the wires are still there to save.
         public void RefreshPorts()
         {
-            while (Inputs.Count < 10) Inputs.Add(new InputPort() { ParentNode = this });
-            while (Inputs.Count > 10) Inputs.RemoveAt(Inputs.Count - 1);
+            int inputs = 0, outputs = 0;
+            foreach (var node in InternalEngine.Nodes)
+            {
+                if (node is ToyInputNode tin) inputs = Math.Max(inputs, tin.Index + 1);
+                else if (node is ToyOutputNode ton) outputs = Math.Max(outputs, ton.Index + 1);
+            }
 
-            while (Outputs.Count < 10) Outputs.Add(new OutputPort() { ParentNode = this });
-            while (Outputs.Count > 10) Outputs.RemoveAt(Outputs.Count - 1);
+            if (LoadError == null)
+            {
+                while (Inputs.Count > inputs) Inputs.RemoveAt(Inputs.Count - 1);
+                while (Outputs.Count > outputs) Outputs.RemoveAt(Outputs.Count - 1);
+            }
+            while (Inputs.Count < inputs) AddInput($"In {Inputs.Count}");
+            while (Outputs.Count < outputs) AddOutput($"Out {Outputs.Count}");
+            _boundaryPlan = null;
+        }
+
+        // A toy whose design could not be read keeps the ports its saved wires use, so they
+        // are written back on the next save; a readable design decides its own ports.
+        public void EnsurePorts(int inputs, int outputs)
+        {
+            if (LoadError == null) return;
+            while (Inputs.Count < Math.Min(inputs, MaxPorts)) AddInput($"In {Inputs.Count}");
+            while (Outputs.Count < Math.Min(outputs, MaxPorts)) AddOutput($"Out {Outputs.Count}");
+            _boundaryPlan = null;
+        }
+
+        // Call after InternalRects change
+        public void UpdateLayoutHash()
+        {
+            int hash = InternalRects.Count;
+            foreach (var r in InternalRects.Values) hash = hash * 31 + r.GetHashCode();
+            LayoutHash = hash;
         }
 
         public ScreenNode GetScreenNode()
@@ -2,7 +2,7 @@ using Microsoft.Xna.Framework;
 
 namespace ToyConEngine {
     // A Button Node (Click to activate)
-    public class ButtonNode : Node
+    public class ButtonNode : Node, IInjectableInput
     {
         public bool IsPressed { get; set; }
         public bool IsToggle { get; set; }
@@ -17,5 +17,11 @@ namespace ToyConEngine {
         {
             Outputs[0].SetValue(IsPressed ? 1.0f : 0.0f);
         }
+
+        // Same as a click; the mouse only overrides it when it presses or releases the button
+        public void Inject(int port, float value)
+        {
+            if (!float.IsNaN(value)) IsPressed = value > 0;
+        }
     }
 }
\ No newline at end of file
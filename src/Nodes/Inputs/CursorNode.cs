@@ -1,10 +1,11 @@
 using Microsoft.Xna.Framework;
-using Microsoft.Xna.Framework.Input;
 
 namespace ToyConEngine
 {
-    public class CursorNode : Node
+    public class CursorNode : Node, IInjectableInput
     {
+        private readonly float[] _injected = { float.NaN, float.NaN };
+
         public CursorNode()
         {
             Name = "Cursor";
@@ -12,6 +13,16 @@ namespace ToyConEngine
             AddOutput("Y");
         }
 
-        public override void Evaluate(GameTime gameTime) => Outputs[0].SetValue(Mouse.GetState().X);
+        public override void Evaluate(GameTime gameTime)
+        {
+            var mouse = InputSnapshot.Mouse;
+            Outputs[0].SetValue(float.IsNaN(_injected[0]) ? mouse.X : _injected[0]);
+            Outputs[1].SetValue(float.IsNaN(_injected[1]) ? mouse.Y : _injected[1]);
+        }
+
+        public void Inject(int port, float value)
+        {
+            if (port >= 0 && port < _injected.Length) _injected[port] = value;
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+namespace ToyConEngine
+{
+    // Input nodes whose outputs can be driven from outside (see InputInjector).
+    // An injected value holds until the next injection; NaN hands the port back to live input.
+    public interface IInjectableInput
+    {
+        void Inject(int port, float value);
+    }
+}
@@ -3,9 +3,10 @@ using Microsoft.Xna.Framework.Input;
 
 namespace ToyConEngine {
     // A Keyboard Key Node
-    public class KeyNode : Node
+    public class KeyNode : Node, IInjectableInput
     {
         public Keys Key { get; set; } = Keys.Space;
+        private float _injected = float.NaN;
 
         public KeyNode()
         {
@@ -15,7 +16,10 @@ namespace ToyConEngine {
 
         public override void Evaluate(GameTime gameTime)
         {
-            Outputs[0].SetValue(Keyboard.GetState().IsKeyDown(Key) ? 1.0f : 0.0f);
+            if (!float.IsNaN(_injected)) { Outputs[0].SetValue(_injected); return; }
+            Outputs[0].SetValue(InputSnapshot.Keyboard.IsKeyDown(Key) ? 1.0f : 0.0f);
         }
+
+        public void Inject(int port, float value) => _injected = value;
     }
 }
\ No newline at end of file
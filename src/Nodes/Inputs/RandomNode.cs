@@ -5,7 +5,8 @@ namespace ToyConEngine
 {
     public class RandomNode : Node
     {
-        private static readonly Random _random = new Random();
+        // One generator per node: background tabs tick on worker threads and Random is not thread-safe
+        private readonly Random _random = new Random();
 
         public RandomNode()
         {
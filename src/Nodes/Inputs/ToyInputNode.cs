@@ -3,14 +3,23 @@ using System.Collections.Generic;
 
 namespace ToyConEngine
 {
-    public class ToyInputNode : Node
+    public class ToyInputNode : Node, IInjectableInput
     {
         public int Index { get; set; } = 0;
+        private float _injected = float.NaN;
+
         public ToyInputNode()
         {
             Name = "Toy Input";
             Outputs = new List<OutputPort> { new OutputPort() { ParentNode = this } };
         }
-        public override void Evaluate(GameTime gameTime) { }
+
+        // Normally the parent ToyNode sets the output; an injected value takes over from it
+        public override void Evaluate(GameTime gameTime)
+        {
+            if (!float.IsNaN(_injected)) Outputs[0].SetValue(_injected);
+        }
+
+        public void Inject(int port, float value) => _injected = value;
     }
 }
\ No newline at end of file
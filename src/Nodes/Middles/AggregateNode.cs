@@ -0,0 +1,77 @@
+using Microsoft.Xna.Framework;
+
+namespace ToyConEngine
+{
+    // N-ary reduction (a + b + c + ...) in one node instead of a chain of MathNodes
+    public class AggregateNode : Node, IGrowablePorts
+    {
+        public enum AggregateType { Sum, Product, Min, Max }
+        public const int MinInputs = 2;
+        public const int MaxInputs = 16;
+
+        private AggregateType _type;
+        private int _inputCount;
+
+        public AggregateType Type
+        {
+            get => _type;
+            set { _type = value; Name = $"{_type} ({_inputCount})"; }
+        }
+
+        // Inputs that take part in the reduction. Lowering it leaves the ports above it (and
+        // their wires) in place, ignored, so raising it again brings them back.
+        public int InputCount
+        {
+            get => _inputCount;
+            set
+            {
+                _inputCount = System.Math.Clamp(value, MinInputs, MaxInputs);
+                while (Inputs.Count < _inputCount) AddInput($"In {Inputs.Count + 1}");
+                for (int i = 0; i < Inputs.Count; i++) Inputs[i].Name = i < _inputCount ? $"In {i + 1}" : "(unused)";
+                Name = $"{_type} ({_inputCount})";
+            }
+        }
+
+        public AggregateNode(AggregateType type, int inputCount = MinInputs)
+        {
+            Type = type;
+            InputCount = inputCount;
+            AddOutput("Result");
+        }
+
+        public void EnsurePorts(int inputs, int outputs)
+        {
+            while (Inputs.Count < System.Math.Min(inputs, MaxInputs)) AddInput("(unused)");
+        }
+
+        public override void Evaluate(GameTime gameTime)
+        {
+            float result = Inputs[0].GetValue();
+            for (int i = 1; i < _inputCount; i++) result = Combine(Type, result, Inputs[i].GetValue());
+            Outputs[0].SetValue(result);
+        }
+
+        public static float Combine(AggregateType type, float acc, float v)
+        {
+            switch (type)
+            {
+                case AggregateType.Sum: return acc + v;
+                case AggregateType.Product: return acc * v;
+                case AggregateType.Min: return System.Math.Min(acc, v);
+                default: return System.Math.Max(acc, v);
+            }
+        }
+
+        // Neutral element, used to pad short nodes in an AggregateBatch
+        public static float Identity(AggregateType type)
+        {
+            switch (type)
+            {
+                case AggregateType.Sum: return 0f;
+                case AggregateType.Product: return 1f;
+                case AggregateType.Min: return float.PositiveInfinity;
+                default: return float.NegativeInfinity;
+            }
+        }
+    }
+}
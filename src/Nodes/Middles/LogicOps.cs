@@ -0,0 +1,53 @@
+using System;
+
+namespace ToyConEngine
+{
+    // One struct per LogicNode.LogicType, specialized through LogicKernel<TOp> (see MathOps)
+    public interface ILogicOp
+    {
+        static abstract int Arity { get; }
+        static abstract bool Apply(float a, float b);
+    }
+
+    // Logic in GBG usually treats > 0 as True
+    internal static class LogicTruth
+    {
+        public static bool IsTrue(float v) => Math.Abs(v) > 0.001f;
+    }
+
+    public struct AndOp : ILogicOp { public static int Arity => 2; public static bool Apply(float a, float b) => LogicTruth.IsTrue(a) & LogicTruth.IsTrue(b); }
+    public struct NotOp : ILogicOp { public static int Arity => 1; public static bool Apply(float a, float b) => !LogicTruth.IsTrue(a); }
+    public struct GreaterThanOp : ILogicOp { public static int Arity => 2; public static bool Apply(float a, float b) => a > b; }
+    public struct LessThanOp : ILogicOp { public static int Arity => 2; public static bool Apply(float a, float b) => a < b; }
+    public struct OrOp : ILogicOp { public static int Arity => 2; public static bool Apply(float a, float b) => LogicTruth.IsTrue(a) | LogicTruth.IsTrue(b); }
+    public struct XorOp : ILogicOp { public static int Arity => 2; public static bool Apply(float a, float b) => LogicTruth.IsTrue(a) ^ LogicTruth.IsTrue(b); }
+
+    public abstract class LogicKernel
+    {
+        public abstract void Evaluate(LogicNode node);
+
+        public static LogicKernel For(LogicNode.LogicType type) => type switch
+        {
+            LogicNode.LogicType.And => LogicKernel<AndOp>.Instance,
+            LogicNode.LogicType.Not => LogicKernel<NotOp>.Instance,
+            LogicNode.LogicType.GreaterThan => LogicKernel<GreaterThanOp>.Instance,
+            LogicNode.LogicType.LessThan => LogicKernel<LessThanOp>.Instance,
+            LogicNode.LogicType.Or => LogicKernel<OrOp>.Instance,
+            LogicNode.LogicType.Xor => LogicKernel<XorOp>.Instance,
+            _ => throw new ArgumentOutOfRangeException(nameof(type))
+        };
+    }
+
+    public sealed class LogicKernel<TOp> : LogicKernel where TOp : struct, ILogicOp
+    {
+        public static readonly LogicKernel<TOp> Instance = new LogicKernel<TOp>();
+
+        public override void Evaluate(LogicNode node)
+        {
+            var inputs = node.Inputs;
+            float a = inputs[0].GetValue();
+            float b = TOp.Arity > 1 && inputs.Count > 1 ? inputs[1].GetValue() : 0;
+            node.Outputs[0].SetValue(TOp.Apply(a, b) ? 1.0f : 0.0f);
+        }
+    }
+}
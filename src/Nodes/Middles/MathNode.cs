@@ -1,38 +1,74 @@
 using Microsoft.Xna.Framework;
-using System;
 
 namespace ToyConEngine
 {
-    public class MathNode : Node
+    public class MathNode : Node, IGrowablePorts
     {
-        public enum Operation { Add, Subtract, Multiply, Divide, Abs, Select }
-        public Operation Op { get; set; }
+        public enum Operation { Add, Subtract, Multiply, Divide, Abs, Select, Min, Max, Modulo, Sin, Cos, Floor, Clamp, Lerp, ApproxEqual }
+        public static readonly int OperationCount = System.Enum.GetValues<Operation>().Length;
+
+        private Operation _op;
+        private MathKernel _kernel;
+
+        // Setting the Op swaps in the kernel specialized for it (see MathOps) and adds any
+        // inputs the new Op reads. Inputs are never removed, so cycling through a one-input Op
+        // keeps the wires on B and C; the kernel just ignores them while they are unused.
+        public Operation Op
+        {
+            get => _op;
+            set { _op = value; _kernel = MathKernel.For(value); RefreshPorts(); }
+        }
 
         public MathNode(Operation op)
         {
             Name = $"Math ({op})";
             Op = op;
-            AddInput("A");
-            if (op != Operation.Abs) AddInput("B");
-            if (op == Operation.Select) AddInput("C");
             AddOutput("Result");
         }
 
-        public override void Evaluate(GameTime gameTime)
+        public override void Evaluate(GameTime gameTime) => _kernel.Evaluate(this);
+
+        public static int ArityOf(Operation op)
+        {
+            switch (op)
+            {
+                case Operation.Abs:
+                case Operation.Sin:
+                case Operation.Cos:
+                case Operation.Floor:
+                    return 1;
+                case Operation.Select:
+                case Operation.Clamp:
+                case Operation.Lerp:
+                case Operation.ApproxEqual:
+                    return 3;
+                default:
+                    return 2;
+            }
+        }
+
+        private static string[] PortNames(Operation op)
         {
-            float a = Inputs[0].GetValue();
-            float b = Inputs.Count > 1 ? Inputs[1].GetValue() : 0;
-            float result = 0;
-            switch (Op)
+            switch (op)
             {
-                case Operation.Add: result = a + b; break;
-                case Operation.Subtract: result = a - b; break;
-                case Operation.Multiply: result = a * b; break;
-                case Operation.Divide: result = b != 0 ? a / b : 0; break;
-                case Operation.Abs: result = Math.Abs(a); break;
-                case Operation.Select: result = a > 0 ? b : (Inputs.Count > 2 ? Inputs[2].GetValue() : 0); break;
+                case Operation.Clamp: return new[] { "X", "Min", "Max" };
+                case Operation.Lerp: return new[] { "A", "B", "T" };
+                case Operation.ApproxEqual: return new[] { "A", "B", "Tol" };
+                default: return new[] { "A", "B", "C" };
             }
-            Outputs[0].SetValue(result);
+        }
+
+        public void EnsurePorts(int inputs, int outputs)
+        {
+            while (Inputs.Count < inputs) AddInput("(unused)");
+        }
+
+        private void RefreshPorts()
+        {
+            int arity = ArityOf(_op);
+            var names = PortNames(_op);
+            while (Inputs.Count < arity) AddInput(names[Inputs.Count]);
+            for (int i = 0; i < Inputs.Count; i++) Inputs[i].Name = i < arity ? names[i] : "(unused)";
         }
     }
-}
\ No newline at end of file
+}
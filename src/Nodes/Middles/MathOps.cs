@@ -0,0 +1,70 @@
+using System;
+
+namespace ToyConEngine
+{
+    // One struct per MathNode.Operation. MathKernel<TOp> is specialized per struct by the
+    // JIT, so Apply is inlined and the per-tick switch on Op disappears.
+    public interface IMathOp
+    {
+        static abstract int Arity { get; }
+        static abstract float Apply(float a, float b, float c);
+    }
+
+    public struct AddOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => a + b; }
+    public struct SubtractOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => a - b; }
+    public struct MultiplyOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => a * b; }
+    public struct DivideOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => b != 0 ? a / b : 0; }
+    public struct AbsOp : IMathOp { public static int Arity => 1; public static float Apply(float a, float b, float c) => Math.Abs(a); }
+    public struct SelectOp : IMathOp { public static int Arity => 3; public static float Apply(float a, float b, float c) => a > 0 ? b : c; }
+    public struct MinOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => Math.Min(a, b); }
+    public struct MaxOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => Math.Max(a, b); }
+    // Floored modulo so negative counters still wrap into [0, b)
+    public struct ModuloOp : IMathOp { public static int Arity => 2; public static float Apply(float a, float b, float c) => b != 0 ? a - b * MathF.Floor(a / b) : 0; }
+    public struct SinOp : IMathOp { public static int Arity => 1; public static float Apply(float a, float b, float c) => MathF.Sin(a); }
+    public struct CosOp : IMathOp { public static int Arity => 1; public static float Apply(float a, float b, float c) => MathF.Cos(a); }
+    public struct FloorOp : IMathOp { public static int Arity => 1; public static float Apply(float a, float b, float c) => MathF.Floor(a); }
+    // Math.Clamp throws when min > max, wires can produce that
+    public struct ClampOp : IMathOp { public static int Arity => 3; public static float Apply(float a, float b, float c) => Math.Min(Math.Max(a, b), c); }
+    public struct LerpOp : IMathOp { public static int Arity => 3; public static float Apply(float a, float b, float c) => a + (b - a) * c; }
+    public struct ApproxEqualOp : IMathOp { public static int Arity => 3; public static float Apply(float a, float b, float c) => Math.Abs(a - b) <= c ? 1 : 0; }
+
+    public abstract class MathKernel
+    {
+        public abstract void Evaluate(MathNode node);
+
+        public static MathKernel For(MathNode.Operation op) => op switch
+        {
+            MathNode.Operation.Add => MathKernel<AddOp>.Instance,
+            MathNode.Operation.Subtract => MathKernel<SubtractOp>.Instance,
+            MathNode.Operation.Multiply => MathKernel<MultiplyOp>.Instance,
+            MathNode.Operation.Divide => MathKernel<DivideOp>.Instance,
+            MathNode.Operation.Abs => MathKernel<AbsOp>.Instance,
+            MathNode.Operation.Select => MathKernel<SelectOp>.Instance,
+            MathNode.Operation.Min => MathKernel<MinOp>.Instance,
+            MathNode.Operation.Max => MathKernel<MaxOp>.Instance,
+            MathNode.Operation.Modulo => MathKernel<ModuloOp>.Instance,
+            MathNode.Operation.Sin => MathKernel<SinOp>.Instance,
+            MathNode.Operation.Cos => MathKernel<CosOp>.Instance,
+            MathNode.Operation.Floor => MathKernel<FloorOp>.Instance,
+            MathNode.Operation.Clamp => MathKernel<ClampOp>.Instance,
+            MathNode.Operation.Lerp => MathKernel<LerpOp>.Instance,
+            MathNode.Operation.ApproxEqual => MathKernel<ApproxEqualOp>.Instance,
+            _ => throw new ArgumentOutOfRangeException(nameof(op))
+        };
+    }
+
+    public sealed class MathKernel<TOp> : MathKernel where TOp : struct, IMathOp
+    {
+        public static readonly MathKernel<TOp> Instance = new MathKernel<TOp>();
+
+        public override void Evaluate(MathNode node)
+        {
+            var inputs = node.Inputs;
+            // Ports can be missing when the Op was changed after construction
+            float a = inputs[0].GetValue();
+            float b = TOp.Arity > 1 && inputs.Count > 1 ? inputs[1].GetValue() : 0;
+            float c = TOp.Arity > 2 && inputs.Count > 2 ? inputs[2].GetValue() : 0;
+            node.Outputs[0].SetValue(TOp.Apply(a, b, c));
+        }
+    }
+}
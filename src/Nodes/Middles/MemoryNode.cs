@@ -0,0 +1,126 @@
+using Microsoft.Xna.Framework;
+using System;
+
+namespace ToyConEngine
+{
+    // RAM/ROM block: one indexed read, one indexed write, backed by a flat float array.
+    // Replaces big Constant + Select trees for sprites, melodies and state tables.
+    public class MemoryNode : Node
+    {
+        public const int MaxSize = 1 << 20;
+
+        public float[] Data { get; private set; }
+        public bool IsReadOnly { get; set; }
+
+        public int Size
+        {
+            get => Data.Length;
+            set
+            {
+                var data = Data;
+                Array.Resize(ref data, Math.Clamp(value, 1, MaxSize));
+                Data = data;
+                UpdateName();
+            }
+        }
+
+        public MemoryNode(int size = 256, bool readOnly = false)
+        {
+            Data = new float[Math.Clamp(size, 1, MaxSize)];
+            IsReadOnly = readOnly;
+            UpdateName();
+            AddInput("Addr");
+            AddInput("Data");
+            AddInput("Write");
+            AddOutput("Out");
+        }
+
+        public override void Evaluate(GameTime gameTime)
+        {
+            int addr = (int)MathF.Floor(Inputs[0].GetValue());
+            bool inRange = addr >= 0 && addr < Data.Length;
+
+            if (inRange && !IsReadOnly && Inputs[2].GetValue() > 0)
+                Data[addr] = Inputs[1].GetValue();
+
+            Outputs[0].SetValue(inRange ? Data[addr] : 0f);
+        }
+
+        public void UpdateName() => Name = $"{(IsReadOnly ? "ROM" : "RAM")} ({Data.Length})";
+
+        // Raw binary file: one cell per byte (0-255)
+        public void LoadBytes(byte[] bytes)
+        {
+            Data = new float[Math.Clamp(bytes.Length, 1, MaxSize)];
+            for (int i = 0; i < bytes.Length && i < Data.Length; i++) Data[i] = bytes[i];
+            UpdateName();
+        }
+
+        // Image: R, G, B per pixel in 0-1, row-major, so Addr = (y * width + x) * 3 + channel
+        // feeds a ScreenNode directly
+        public void LoadPixels(Color[] pixels)
+        {
+            Data = new float[Math.Clamp(pixels.Length * 3, 1, MaxSize)];
+            for (int i = 0; i < pixels.Length && i * 3 + 2 < Data.Length; i++)
+            {
+                Data[i * 3] = pixels[i].R / 255f;
+                Data[i * 3 + 1] = pixels[i].G / 255f;
+                Data[i * 3 + 2] = pixels[i].B / 255f;
+            }
+            UpdateName();
+        }
+
+        // Design file form: "<size> <ROM|RAM> <B|F> <base64>". Trailing zero cells are
+        // dropped and all-byte contents are stored one byte per cell.
+        public string Serialize() => Serialize(Data, IsReadOnly);
+
+        // Same, from a copy of the contents, so it can run off the tick thread
+        public static string Serialize(float[] data, bool readOnly)
+        {
+            int used = data.Length;
+            while (used > 0 && data[used - 1] == 0) used--;
+
+            bool bytes = true;
+            for (int i = 0; i < used && bytes; i++)
+            {
+                float v = data[i];
+                bytes = v >= 0 && v <= 255 && v == MathF.Floor(v);
+            }
+
+            byte[] payload;
+            if (bytes)
+            {
+                payload = new byte[used];
+                for (int i = 0; i < used; i++) payload[i] = (byte)data[i];
+            }
+            else
+            {
+                payload = new byte[used * sizeof(float)];
+                Buffer.BlockCopy(data, 0, payload, 0, payload.Length);
+            }
+
+            return $"{data.Length} {(readOnly ? "ROM" : "RAM")} {(bytes ? "B" : "F")} {Convert.ToBase64String(payload)}";
+        }
+
+        public void Deserialize(string data)
+        {
+            var fields = data.Split(' ');
+            Data = new float[Math.Clamp(int.Parse(fields[0]), 1, MaxSize)];
+            IsReadOnly = fields.Length > 1 && fields[1] == "ROM";
+
+            if (fields.Length > 3 && fields[3].Length > 0)
+            {
+                byte[] payload = Convert.FromBase64String(fields[3]);
+                if (fields[2] == "B")
+                {
+                    for (int i = 0; i < payload.Length && i < Data.Length; i++) Data[i] = payload[i];
+                }
+                else
+                {
+                    Buffer.BlockCopy(payload, 0, Data, 0, Math.Min(payload.Length, Data.Length * sizeof(float)));
+                }
+            }
+            UpdateName();
+        }
+    }
+}
@@ -6,6 +6,8 @@ namespace ToyConEngine
     public abstract class Node
     {
         public string Name { get; set; }
+        // Stable across saves and loads; assigned by GraphEngine.AddNode (0 = not assigned yet)
+        public int Id { get; set; }
         public List<InputPort> Inputs { get; set; } = new List<InputPort>();
         public List<OutputPort> Outputs { get; set; } = new List<OutputPort>();
 
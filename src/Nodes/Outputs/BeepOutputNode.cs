@@ -18,6 +18,12 @@ namespace ToyConEngine
             AddInput("Pitch");
         }
 
-        public override void Evaluate(GameTime gameTime) => ShouldPlay = Inputs[0].GetValue() > 0 && !_prevTrigger;
+        // Fires on the rising edge only, so a held trigger plays once rather than every tick
+        public override void Evaluate(GameTime gameTime)
+        {
+            bool trigger = Inputs[0].GetValue() > 0;
+            ShouldPlay = trigger && !_prevTrigger;
+            _prevTrigger = trigger;
+        }
     }
 }
\ No newline at end of file
@@ -7,6 +7,8 @@ namespace ToyConEngine
         public const int Width = 64;
         public const int Height = 64;
         public Color[] Buffer;
+        // Bumped whenever Buffer may have changed, so readers can skip copying an unchanged picture
+        public int Version;
 
         public ScreenNode()
         {
@@ -28,6 +30,7 @@ namespace ToyConEngine
             if (Inputs[6].GetValue() > 0) // Clear
             {
                 for (int i = 0; i < Buffer.Length; i++) Buffer[i] = Color.Black;
+                Version++;
             }
 
             if (Inputs[5].GetValue() > 0) // Draw
@@ -40,7 +43,8 @@ namespace ToyConEngine
 
                 if (x >= 0 && x < Width && y >= 0 && y < Height)
                 {
-                    Buffer[y * Width + x] = new Color(r, g, b);
+                    var color = new Color(r, g, b);
+                    if (Buffer[y * Width + x] != color) { Buffer[y * Width + x] = color; Version++; }
                 }
             }
         }
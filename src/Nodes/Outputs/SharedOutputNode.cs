@@ -0,0 +1,23 @@
+using Microsoft.Xna.Framework;
+
+namespace ToyConEngine
+{
+    // Marks values for external processes. While the shared output channel is open its
+    // inputs are published as ports Bank * 8 .. Bank * 8 + 7 after every tick.
+    public class SharedOutputNode : Node
+    {
+        public const int PortsPerBank = 8;
+        public const int BankCount = SharedOutputChannel.PortCount / PortsPerBank;
+
+        public int Bank { get; set; } = 0;
+
+        public SharedOutputNode()
+        {
+            Name = "Shared Out";
+            for (int i = 0; i < PortsPerBank; i++) AddInput(i.ToString());
+        }
+
+        // Nothing to do here; the channel reads the inputs straight into shared memory
+        public override void Evaluate(GameTime gameTime) { }
+    }
+}
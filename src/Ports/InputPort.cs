@@ -1,5 +1,4 @@
 using System.Collections.Generic;
-using System.Linq;
 
  namespace ToyConEngine {
     // Input Port (Connection Points)
@@ -11,9 +10,19 @@ using System.Linq;
 
         public float GetValue()
         {
+            var sources = ConnectedSources;
             // If nothing is connected, return default (0)
-            if (ConnectedSources.Count == 0) return 0.0f;
-            return ConnectedSources.Max(s => s.Value);
+            if (sources.Count == 0) return 0.0f;
+            if (sources.Count == 1) return sources[0].Value;
+
+            // Several wires into one port: the strongest signal wins
+            float max = sources[0].Value;
+            for (int i = 1; i < sources.Count; i++)
+            {
+                float v = sources[i].Value;
+                if (v > max) max = v;
+            }
+            return max;
         }
     }
-}
\ No newline at end of file
+}
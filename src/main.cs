@@ -3,10 +3,14 @@ namespace ToyConEngine
     //main
     public static class Program
     {
-        static void Main(string[] args)
+        static int Main(string[] args)
         {
+            if (args.Length > 0 && args[0] == "--headless") return HeadlessHost.Run(args[1..]);
+            if (args.Length > 0 && args[0] == "--partition-worker") return HeadlessHost.RunPartitionWorker(args[1..]);
+
             using var game = new ToyConGame();
             game.Run();
+            return 0;
         }
     }
 }
\ No newline at end of file
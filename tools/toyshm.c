@@ -0,0 +1,143 @@
+// toyshm.c
+// Implementation of toyshm.h. Works on Windows and POSIX systems.
+
+#include "toyshm.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define toyshm_fence() MemoryBarrier()
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define toyshm_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+static uint64_t load_u64(const uint8_t* p) {
+    uint64_t v;
+    toyshm_fence();
+    memcpy(&v, p, sizeof(v));
+    toyshm_fence();
+    return v;
+}
+
+int toyshm_open(toyshm_reader* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return -1;
+    r->base = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (r->base == NULL) { CloseHandle(mapping); return -1; }
+    r->handle = mapping;
+    r->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return -1; }
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+    r->base = (const uint8_t*)base;
+    r->size = (size_t)st.st_size;
+#endif
+
+    r->header = (const toyshm_header*)r->base;
+    if (r->size < sizeof(toyshm_header) || memcmp(r->header->magic, TOYSHM_MAGIC, 8) != 0 ||
+        r->size < (size_t)r->header->header_size + (size_t)r->header->slot_count * r->header->slot_size) {
+        toyshm_close(r);
+        return -1;
+    }
+    return 0;
+}
+
+void toyshm_close(toyshm_reader* r) {
+    if (r->base == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(r->base);
+    CloseHandle((HANDLE)r->handle);
+#else
+    munmap((void*)r->base, r->size);
+#endif
+    memset(r, 0, sizeof(*r));
+}
+
+uint64_t toyshm_published(const toyshm_reader* r) {
+    return load_u64(r->base + TOYSHM_WRITE_INDEX_OFFSET);
+}
+
+int toyshm_read(const toyshm_reader* r, uint64_t n, uint64_t* tick, float* ports, uint32_t* pixels) {
+    const toyshm_header* h = r->header;
+    uint64_t published = toyshm_published(r);
+    if (n >= published) return 1;
+    if (published - n > h->slot_count) return -1;
+
+    const uint8_t* slot = r->base + h->header_size + (n % h->slot_count) * (uint64_t)h->slot_size;
+    size_t pixel_count = (size_t)h->screen_count * h->screen_width * h->screen_height;
+
+    // Seqlock: an odd or changed sequence means the engine was writing this slot
+    uint64_t before = load_u64(slot);
+    if (before & 1) return -1;
+
+    if (tick) memcpy(tick, slot + 8, sizeof(*tick));
+    if (ports) memcpy(ports, slot + TOYSHM_PORTS_OFFSET, h->port_count * sizeof(float));
+    if (pixels) memcpy(pixels, slot + TOYSHM_PORTS_OFFSET + h->port_count * sizeof(float), pixel_count * sizeof(uint32_t));
+
+    uint64_t after = load_u64(slot);
+    if (before != after) return -1;
+
+    // The slot may have been reused for a later tick before we started; that is still a lap
+    return toyshm_published(r) - n > h->slot_count ? -1 : 0;
+}
+
+int toyshm_read_latest(const toyshm_reader* r, uint64_t* tick, float* ports, uint32_t* pixels) {
+    for (;;) {
+        uint64_t published = toyshm_published(r);
+        if (published == 0) return 1;
+        if (toyshm_read(r, published - 1, tick, ports, pixels) == 0) return 0;
+    }
+}
+
+#ifdef TOYSHM_DUMP
+// Example consumer: prints the tick and the first 8 ports of every published slot.
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "/dev/shm/toycon_output";
+    toyshm_reader r;
+    if (toyshm_open(&r, path) != 0) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    float* ports = (float*)malloc(r.header->port_count * sizeof(float));
+    uint64_t next = toyshm_published(&r);
+    uint64_t dropped = 0;
+    for (;;) {
+        uint64_t tick;
+        int result = toyshm_read(&r, next, &tick, ports, NULL);
+        if (result == 1) continue; // spin until the engine publishes
+        if (result < 0) {
+            // Fell more than a ring behind: skip to the newest slot
+            uint64_t latest = toyshm_published(&r) - 1;
+            dropped += latest - next;
+            next = latest;
+            continue;
+        }
+        printf("tick %llu:", (unsigned long long)tick);
+        for (uint32_t i = 0; i < 8 && i < r.header->port_count; i++) printf(" %g", ports[i]);
+        printf(" (dropped %llu)\n", (unsigned long long)dropped);
+        next++;
+    }
+}
+#endif
@@ -0,0 +1,68 @@
+// toyshm.h
+// Reader for the ToyCon shared output channel (File -> Share Output in the editor).
+// The engine publishes Shared Out ports and Screen framebuffers into a memory-mapped
+// ring after every tick; this reads them without ever blocking the engine.
+//
+// To compile, add toyshm.c to your program:
+//   cc -O2 -c toyshm.c
+// or build the example dump tool:
+//   cc -O2 -DTOYSHM_DUMP -o toyshm toyshm.c
+//
+// Usage:
+//   toyshm_reader r;
+//   if (toyshm_open(&r, "/dev/shm/toycon_output") == 0) {
+//       float ports[TOYSHM_MAX_PORTS];
+//       uint64_t tick;
+//       if (toyshm_read_latest(&r, &tick, ports, NULL) == 0) printf("%llu %f\n", tick, ports[0]);
+//       toyshm_close(&r);
+//   }
+
+#ifndef TOYSHM_H
+#define TOYSHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TOYSHM_MAGIC "TOYSHM01"
+#define TOYSHM_MAX_PORTS 64
+#define TOYSHM_WRITE_INDEX_OFFSET 64
+#define TOYSHM_PORTS_OFFSET 16
+
+// Matches the header at the start of the mapping
+#pragma pack(push, 1)
+typedef struct {
+    char     magic[8];
+    uint32_t header_size;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t port_count;
+    uint32_t screen_width;
+    uint32_t screen_height;
+    uint32_t screen_count;
+} toyshm_header;
+#pragma pack(pop)
+
+typedef struct {
+    const uint8_t*       base;
+    size_t               size;
+    const toyshm_header* header;
+    void*                handle; // platform mapping handle
+} toyshm_reader;
+
+// 0 on success, -1 if the file is missing or not a ToyCon channel
+int toyshm_open(toyshm_reader* r, const char* path);
+void toyshm_close(toyshm_reader* r);
+
+// Number of slots published so far; slot n is valid while n >= published - slot_count
+uint64_t toyshm_published(const toyshm_reader* r);
+
+// Copies slot n. ports needs port_count floats, pixels needs
+// screen_count * screen_width * screen_height RGBA words; either may be NULL.
+// 0 on success, 1 if n is not published yet, -1 if the engine has already overwritten it.
+int toyshm_read(const toyshm_reader* r, uint64_t n, uint64_t* tick, float* ports, uint32_t* pixels);
+
+// Reads the newest slot, retrying if the engine laps the reader mid-copy.
+// 1 if nothing has been published yet.
+int toyshm_read_latest(const toyshm_reader* r, uint64_t* tick, float* ports, uint32_t* pixels);
+
+#endif